@@ -148,6 +148,8 @@ ant_keywords = {
     "handle": "#6897BB",  # (104, 151, 187)
     "try": "#8888C6",  # (136, 136, 198)
     "raise": "#C47432",  # (196, 116, 50)
+    "in": "#A74926",  # (167, 73, 38)
+    "immutable": "#688558",  # (104, 133, 88)
 }
 
 def alter_path(path):
@@ -9,6 +9,8 @@
 #include "objClass.h"
 #include "object.h"
 #include "stringHash.h"
+#include "vm.h"
+#include "runtimeMemoryManager.h"
 
 #include <math.h>
 #include <string.h>
@@ -29,11 +31,13 @@ objClass* stringClass;
 objClass* listClass;
 objClass* dictClass;
 objClass* setClass;
+objClass* floatArrayClass;
+objClass* intArrayClass;
 objClass* exceptionClass;
 
 void addGlobalReference(refTable* globalRefTable, runtimeList* globalRefList, Value val, char* name) {
     if (refTableContains(globalRefTable, name)) compilationError(0, 0, 0, "global reference already exists");
-    uint16_t index = getRefIndex(globalRefTable, name);
+    uint32_t index = getRefIndex(globalRefTable, name);
     if (index != listAddElementReturnIndex(globalRefList, val)) compilationError(0, 0, 0, "reference table and list mismatch");
 }
 
@@ -79,12 +83,16 @@ Value equalPrim(Value self, Value* args, int numArgs) {
 
 Value initList(Value self, Value* args, int numArgs) {
     VALUE_LIST_VALUE(self) = createRuntimeList(RUNTIME_LIST_INIT_SIZE);
-    for (int i=0; i<numArgs; i++) listAddElement(VALUE_LIST_VALUE(self), args[i]);
+    for (int i=0; i<numArgs; i++) {
+        listAddElement(VALUE_LIST_VALUE(self), args[i]);
+        GC_WRITE_BARRIER(self.obj, args[i]);
+    }
     return NONE_VAL;
 }
 
 Value listAdd(Value self, Value* args, int numArgs) {
     listAddElement(VALUE_LIST_VALUE(self), args[0]);
+    GC_WRITE_BARRIER(self.obj, args[0]);
     return NONE_VAL;
 }
 
@@ -94,6 +102,7 @@ Value listInsert(Value self, Value* args, int numArgs) {
         return NONE_VAL;
     }
     listInsertElement(VALUE_LIST_VALUE(self), VALUE_NUMBER_VALUE(args[0]), args[1]);
+    GC_WRITE_BARRIER(self.obj, args[1]);
     return NONE_VAL;
 }
 
@@ -103,6 +112,7 @@ Value listSet(Value self, Value* args, int numArgs) {
         return NONE_VAL;
     }
     listSetElement(VALUE_LIST_VALUE(self),VALUE_NUMBER_VALUE(args[0]), args[1]);
+    GC_WRITE_BARRIER(self.obj, args[1]);
     return NONE_VAL;
 }
 
@@ -140,6 +150,101 @@ Value listSize(Value self, Value* args, int numArgs) {
     return resultObj;
 }
 
+Value listSortMethod(Value self, Value* args, int numArgs) {
+    if (numArgs > 1) {
+        raiseExceptionByName("ParameterError", "Invalid number of arguments for sort");
+        return NONE_VAL;
+    }
+    runtimeList* list = VALUE_LIST_VALUE(self);
+    if (numArgs == 0) {
+        listSort(list, NULL);
+        return NONE_VAL;
+    }
+    Value keyFunc = args[0];
+    if (VALUE_TYPE(keyFunc) != BUILTIN_CALLABLE) {
+        raiseExceptionByName("TypeError", "Object is not callable");
+        return NONE_VAL;
+    }
+    // Keys are computed once, the key list sits on the VM stack so collections triggered by the key function see it
+    Value keys = OBJECT_VAL(createRuntimeListObject(), BUILTIN_LIST);
+    Value* savedStackTop = vm->stackTop;
+    *vm->stackTop++ = keys;
+    for (uint32_t i=0; i<list->size; i++) {
+        Value key = execInput(keyFunc, NONE_VAL, &list->list[i], 1);
+        if (vm->panic) break;
+        listAddElement(VALUE_LIST_VALUE(keys), key);
+        // The key list may have been promoted by a collection during the call
+        GC_WRITE_BARRIER(keys.obj, key);
+    }
+    if (!vm->panic) {
+        if (VALUE_LIST_VALUE(keys)->size != list->size) {
+            raiseExceptionByName("ValueError", "List modified during sort");
+        } else {
+            listSort(list, VALUE_LIST_VALUE(keys));
+        }
+    }
+    vm->stackTop = savedStackTop;
+    return NONE_VAL;
+}
+
+// Negative indices count from the end, out of range indices are clamped
+static inline uint32_t clampSliceIndex(double index, uint32_t size) {
+    if (index < 0) index += size;
+    if (index < 0) return 0;
+    if (index > size) return size;
+    return (uint32_t) index;
+}
+
+Value listSliceMethod(Value self, Value* args, int numArgs) {
+    if (numArgs != 1 && numArgs != 2) {
+        raiseExceptionByName("ParameterError", "Invalid number of arguments for slice");
+        return NONE_VAL;
+    }
+    for (int i=0; i<numArgs; i++) {
+        if (VALUE_TYPE(args[i]) != VAL_NUMBER) {
+            raiseExceptionByName("TypeError", "Value is not of type num");
+            return NONE_VAL;
+        }
+        // NaN passes every comparison in clampSliceIndex
+        if (!isfinite(VALUE_NUMBER_VALUE(args[i]))) {
+            raiseExceptionByName("ParameterError", "Slice index must be finite");
+            return NONE_VAL;
+        }
+    }
+    Value result = OBJECT_VAL(createRuntimeListObject(), BUILTIN_LIST);
+    runtimeList* list = VALUE_LIST_VALUE(self);
+    uint32_t start = clampSliceIndex(VALUE_NUMBER_VALUE(args[0]), list->size);
+    uint32_t end = numArgs == 2 ? clampSliceIndex(VALUE_NUMBER_VALUE(args[1]), list->size) : list->size;
+    listSlice(VALUE_LIST_VALUE(result), list, start, end);
+    return result;
+}
+
+Value listCopy(Value self, Value* args, int numArgs) {
+    Value result = OBJECT_VAL(createRuntimeListObject(), BUILTIN_LIST);
+    runtimeList* list = VALUE_LIST_VALUE(self);
+    listSlice(VALUE_LIST_VALUE(result), list, 0, list->size);
+    return result;
+}
+
+Value listReverseMethod(Value self, Value* args, int numArgs) {
+    listReverse(VALUE_LIST_VALUE(self));
+    return NONE_VAL;
+}
+
+Value listExtendMethod(Value self, Value* args, int numArgs) {
+    if (VALUE_TYPE(args[0]) != BUILTIN_LIST) {
+        raiseExceptionByName("TypeError", "List extend requires a list");
+        return NONE_VAL;
+    }
+    listExtend(VALUE_LIST_VALUE(self), VALUE_LIST_VALUE(args[0]));
+    // The new elements may be young or unmarked
+    if (self.obj->isOld) {
+        runtimeList* other = VALUE_LIST_VALUE(args[0]);
+        for (uint32_t i = 0; i < other->size; i++) GC_WRITE_BARRIER(self.obj, other->list[i]);
+    }
+    return NONE_VAL;
+}
+
 // Dict
 Value initDict(Value self, Value* args, int numArgs) {
     if (numArgs % 2 != 0) {
@@ -147,18 +252,23 @@ Value initDict(Value self, Value* args, int numArgs) {
         return NONE_VAL;
     }
     VALUE_DICT_VALUE(self) = createRuntimeDict(RUNTIME_DICT_INIT_SIZE);
-    for (int i=0; i<numArgs; i+=2) dictInsertElement(VALUE_DICT_VALUE(self), args[i], args[i+1]);
+    for (int i=0; i<numArgs; i+=2) {
+        dictInsertElement(VALUE_DICT_VALUE(self), args[i], args[i+1]);
+        GC_WRITE_BARRIER(self.obj, args[i]);
+        GC_WRITE_BARRIER(self.obj, args[i+1]);
+    }
     return NONE_VAL;
 }
 
 Value dictInsert(Value self, Value* args, int numArgs) {
     dictInsertElement(VALUE_DICT_VALUE(self), args[0], args[1]);
+    GC_WRITE_BARRIER(self.obj, args[0]);
+    GC_WRITE_BARRIER(self.obj, args[1]);
     return NONE_VAL;
 }
 
 Value dictGet(Value self, Value* args, int numArgs) {
-    dictGetElement(VALUE_DICT_VALUE(self), args[0]);
-    return NONE_VAL;
+    return dictGetElement(VALUE_DICT_VALUE(self), args[0]);
 }
 
 Value dictContains(Value self, Value* args, int numArgs) {
@@ -179,13 +289,17 @@ Value dictSize(Value self, Value* args, int numArgs) {
 
 // Set
 Value initSet(Value self, Value* args, int numArgs) {
-    VALUE_SET_VALUE(self) = createRuntimeSet(RUNTIME_SET_INIT_SIZE);
-    for (int i=0; i<numArgs; i++) setInsertElement(VALUE_SET_VALUE(self), args[i]);
+    VALUE_SET_VALUE(self) = createRuntimeSet();
+    for (int i=0; i<numArgs; i++) {
+        setInsertElement(VALUE_SET_VALUE(self), args[i]);
+        GC_WRITE_BARRIER(self.obj, args[i]);
+    }
     return NONE_VAL;
 }
 
 Value setInsert(Value self, Value* args, int numArgs) {
     setInsertElement(VALUE_SET_VALUE(self), args[0]);
+    GC_WRITE_BARRIER(self.obj, args[0]);
     return NONE_VAL;
 }
 
@@ -200,11 +314,188 @@ Value setRemove(Value self, Value* args, int numArgs) {
 }
 
 Value setSize(Value self, Value* args, int numArgs) {
-    int result = VALUE_SET_VALUE(self)->dict->numEntries;
+    int result = VALUE_SET_VALUE(self)->numEntries;
     Value resultObj = NUMBER_VAL(result);
     return resultObj;
 }
 
+Value setUnionMethod(Value self, Value* args, int numArgs) {
+    if (VALUE_TYPE(args[0]) != BUILTIN_SET) {
+        raiseExceptionByName("TypeError", "Set union requires a set");
+        return NONE_VAL;
+    }
+    Value result = OBJECT_VAL(createRuntimeSetObject(), BUILTIN_SET);
+    setUnion(VALUE_SET_VALUE(result), VALUE_SET_VALUE(self), VALUE_SET_VALUE(args[0]));
+    return result;
+}
+
+Value setIntersectionMethod(Value self, Value* args, int numArgs) {
+    if (VALUE_TYPE(args[0]) != BUILTIN_SET) {
+        raiseExceptionByName("TypeError", "Set intersection requires a set");
+        return NONE_VAL;
+    }
+    Value result = OBJECT_VAL(createRuntimeSetObject(), BUILTIN_SET);
+    setIntersection(VALUE_SET_VALUE(result), VALUE_SET_VALUE(self), VALUE_SET_VALUE(args[0]));
+    return result;
+}
+
+Value setDifferenceMethod(Value self, Value* args, int numArgs) {
+    if (VALUE_TYPE(args[0]) != BUILTIN_SET) {
+        raiseExceptionByName("TypeError", "Set difference requires a set");
+        return NONE_VAL;
+    }
+    Value result = OBJECT_VAL(createRuntimeSetObject(), BUILTIN_SET);
+    setDifference(VALUE_SET_VALUE(result), VALUE_SET_VALUE(self), VALUE_SET_VALUE(args[0]));
+    return result;
+}
+
+// Float and int arrays
+
+static inline bool checkArrayIndex(Value index) {
+    if (VALUE_TYPE(index) != VAL_NUMBER) {
+        raiseExceptionByName("TypeError", "Value is not of type num");
+        return false;
+    }
+    return true;
+}
+
+static inline bool checkMatchingArray(Value self, Value other) {
+    if (VALUE_TYPE(other) != VALUE_TYPE(self)) {
+        raiseExceptionByName("TypeError", "Array types do not match");
+        return false;
+    }
+    return true;
+}
+
+Value initArray(Value self, Value* args, int numArgs) {
+    runtimeArray* array = createRuntimeArray(0);
+    VALUE_ARRAY_VALUE(self) = array;
+    bool isInt = VALUE_ARRAY_IS_INT(self);
+    // A single list argument is unpacked
+    if (numArgs == 1 && VALUE_TYPE(args[0]) == BUILTIN_LIST) {
+        runtimeList* list = VALUE_LIST_VALUE(args[0]);
+        args = list->list;
+        numArgs = (int) list->size;
+    }
+    for (int i=0; i<numArgs; i++) {
+        if (!checkArrayIndex(args[i])) return NONE_VAL;
+        arrayAddElement(array, isInt, VALUE_NUMBER_VALUE(args[i]));
+    }
+    return NONE_VAL;
+}
+
+Value arrayAddMethod(Value self, Value* args, int numArgs) {
+    if (!checkArrayIndex(args[0])) return NONE_VAL;
+    arrayAddElement(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self), VALUE_NUMBER_VALUE(args[0]));
+    return NONE_VAL;
+}
+
+Value arrayGet(Value self, Value* args, int numArgs) {
+    if (!checkArrayIndex(args[0])) return NONE_VAL;
+    return arrayGetElement(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self), VALUE_NUMBER_VALUE(args[0]));
+}
+
+Value arraySet(Value self, Value* args, int numArgs) {
+    if (!checkArrayIndex(args[0]) || !checkArrayIndex(args[1])) return NONE_VAL;
+    arraySetElement(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self), VALUE_NUMBER_VALUE(args[0]), VALUE_NUMBER_VALUE(args[1]));
+    return NONE_VAL;
+}
+
+Value arraySize(Value self, Value* args, int numArgs) {
+    return NUMBER_VAL(VALUE_ARRAY_VALUE(self)->size);
+}
+
+Value arrayResizeMethod(Value self, Value* args, int numArgs) {
+    if (!checkArrayIndex(args[0])) return NONE_VAL;
+    if (VALUE_NUMBER_VALUE(args[0]) < 0) {
+        raiseExceptionByName("ParameterError", "Array size must not be negative");
+        return NONE_VAL;
+    }
+    arrayResize(VALUE_ARRAY_VALUE(self), VALUE_NUMBER_VALUE(args[0]));
+    return NONE_VAL;
+}
+
+Value arraySumMethod(Value self, Value* args, int numArgs) {
+    return NUMBER_VAL(arraySum(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self)));
+}
+
+Value arrayDotMethod(Value self, Value* args, int numArgs) {
+    if (!checkMatchingArray(self, args[0])) return NONE_VAL;
+    return NUMBER_VAL(arrayDot(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_VALUE(args[0]), VALUE_ARRAY_IS_INT(self)));
+}
+
+Value arrayMinMethod(Value self, Value* args, int numArgs) {
+    return NUMBER_VAL(arrayMin(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self)));
+}
+
+Value arrayMaxMethod(Value self, Value* args, int numArgs) {
+    return NUMBER_VAL(arrayMax(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self)));
+}
+
+Value arrayScaleMethod(Value self, Value* args, int numArgs) {
+    if (!checkArrayIndex(args[0])) return NONE_VAL;
+    arrayScale(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self), VALUE_NUMBER_VALUE(args[0]));
+    return NONE_VAL;
+}
+
+Value arraySortMethod(Value self, Value* args, int numArgs) {
+    arraySort(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self));
+    return NONE_VAL;
+}
+
+Value arrayMap(Value self, Value* args, int numArgs) {
+    Value func = args[0];
+    if (VALUE_TYPE(func) != BUILTIN_CALLABLE) {
+        raiseExceptionByName("TypeError", "Object is not callable");
+        return NONE_VAL;
+    }
+    bool isInt = VALUE_ARRAY_IS_INT(self);
+    // Results go to an unowned buffer, the callable may trigger a collection
+    runtimeArray* mapped = createRuntimeArray(0);
+    for (uint32_t i=0; i<VALUE_ARRAY_VALUE(self)->size; i++) {
+        Value element = arrayGetElement(VALUE_ARRAY_VALUE(self), isInt, i);
+        Value result = execInput(func, NONE_VAL, &element, 1);
+        if (!vm->panic && VALUE_TYPE(result) != VAL_NUMBER) raiseExceptionByName("TypeError", "Array map function must return a num");
+        if (!vm->panic) arrayAddElement(mapped, isInt, VALUE_NUMBER_VALUE(result));
+        if (vm->panic) {
+            freeRuntimeArray(mapped);
+            return NONE_VAL;
+        }
+    }
+    Object* resultObj = createRuntimeObj(VALUE_CLASS(self));
+    resultObj->primValue.array = mapped;
+    return OBJECT_VAL(resultObj, VALUE_TYPE(self));
+}
+
+// Shared by _add and _mul, the other operand is an array of the same type or a num
+static Value arrayBinaryOperation(Value self, Value other, bool multiply) {
+    bool isInt = VALUE_ARRAY_IS_INT(self);
+    if (VALUE_TYPE(other) != VAL_NUMBER && !checkMatchingArray(self, other)) return NONE_VAL;
+    Value result = OBJECT_VAL(createRuntimeArrayObject(VALUE_CLASS(self), 0), VALUE_TYPE(self));
+    runtimeArray* resultArray = VALUE_ARRAY_VALUE(result);
+    if (VALUE_TYPE(other) == VAL_NUMBER) {
+        arrayCopy(resultArray, VALUE_ARRAY_VALUE(self));
+        if (multiply) {
+            arrayScale(resultArray, isInt, VALUE_NUMBER_VALUE(other));
+        } else {
+            arrayAddScalar(resultArray, isInt, VALUE_NUMBER_VALUE(other));
+        }
+    } else if (multiply) {
+        arrayMul(resultArray, VALUE_ARRAY_VALUE(self), VALUE_ARRAY_VALUE(other), isInt);
+    } else {
+        arrayAdd(resultArray, VALUE_ARRAY_VALUE(self), VALUE_ARRAY_VALUE(other), isInt);
+    }
+    return result;
+}
+
+Value arrayAddOperator(Value self, Value* args, int numArgs) {
+    return arrayBinaryOperation(self, args[0], false);
+}
+
+Value arrayMulOperator(Value self, Value* args, int numArgs) {
+    return arrayBinaryOperation(self, args[0], true);
+}
+
 // String
 Value strAdd(Value self, Value* args, int numArgs) {
     // Check other object type
@@ -216,8 +507,8 @@ Value strAdd(Value self, Value* args, int numArgs) {
     char* newStr = malloc(strlen(VALUE_STR_VALUE(self)) + strlen(otherStr) + 1);
     strcpy(newStr, VALUE_STR_VALUE(self));
     strcat(newStr, otherStr);
-    // Use addReference to create a copy in the string dict
-    Value result = OBJECT_VAL(createRuntimeStringObject(addReference(newStr)), BUILTIN_STR);
+    // The string dict keeps its own copy
+    Value result = OBJECT_VAL(createRuntimeStringObject(newStr), BUILTIN_STR);
     // Free the temporary string to avoid memory leak
     free(newStr);
     return result;
@@ -273,8 +564,11 @@ Value hasAttr(Value self, Value* args, int numArgs) {
         return NONE_VAL;
     }
     if (!IS_MARKABLE_VAL(target)) return BOOL_VAL(false);
+    // Names never interned cannot be attributes
+    uint32_t symbol = findSymbol(VALUE_STR_VALUE(attrName));
+    if (symbol == SYMBOL_NONE) return BOOL_VAL(false);
     // Try to find the attribute in the object
-    Value result = ignoreNullGetAttr(target, VALUE_STR_VALUE(attrName));
+    Value result = ignoreNullGetAttr(target, symbol);
     return BOOL_VAL(VALUE_TYPE(result) != VAL_INTERNAL_NULL);
 }
 
@@ -320,6 +614,11 @@ void constructBuiltinClasses(refTable* globalRefTable, runtimeList* globalRefLis
     CLASS_ADD_ATTR(listClass, "contains", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &listContains));
     CLASS_ADD_ATTR(listClass, "index", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &listIndexOf));
     CLASS_ADD_ATTR(listClass, "size", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &listSize));
+    CLASS_ADD_ATTR(listClass, "sort", DEF_BUILTIN_CFUNC_METHOD_VALUE(-1, 0, &listSortMethod));
+    CLASS_ADD_ATTR(listClass, "slice", DEF_BUILTIN_CFUNC_METHOD_VALUE(-1, 1, &listSliceMethod));
+    CLASS_ADD_ATTR(listClass, "copy", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &listCopy));
+    CLASS_ADD_ATTR(listClass, "reverse", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 0, &listReverseMethod));
+    CLASS_ADD_ATTR(listClass, "extend", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 0, &listExtendMethod));
 
     // Dict class
     dictClass = DEF_BUILTIN_CFUNC_INIT_CLASS("dict", getRefIndex(globalClassTable, "dict"), -1, 0, &initDict);
@@ -338,10 +637,36 @@ void constructBuiltinClasses(refTable* globalRefTable, runtimeList* globalRefLis
     CLASS_ADD_ATTR(setClass, "contains", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &setContains));
     CLASS_ADD_ATTR(setClass, "remove", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 0, &setRemove));
     CLASS_ADD_ATTR(setClass, "size", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &setSize));
+    CLASS_ADD_ATTR(setClass, "union", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &setUnionMethod));
+    CLASS_ADD_ATTR(setClass, "intersection", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &setIntersectionMethod));
+    CLASS_ADD_ATTR(setClass, "difference", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &setDifferenceMethod));
 
     // Create exception class
     exceptionClass = createClass("exception", getRefIndex(globalClassTable, "exception"), INTERNAL_NULL_VAL, 0, NONE_INIT_TYPE);
 
+    // Float and int array classes, unboxed numeric storage
+    floatArrayClass = DEF_BUILTIN_CFUNC_INIT_CLASS("floatArray", getRefIndex(globalClassTable, "floatArray"), -1, 0, &initArray);
+    intArrayClass = DEF_BUILTIN_CFUNC_INIT_CLASS("intArray", getRefIndex(globalClassTable, "intArray"), -1, 0, &initArray);
+    objClass* arrayClasses[2] = {floatArrayClass, intArrayClass};
+    for (int i=0; i<2; i++) {
+        objClass* arrayClass = arrayClasses[i];
+        CLASS_ADD_ATTR(arrayClass, "print", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 0, &printPrim));
+        CLASS_ADD_ATTR(arrayClass, "add", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 0, &arrayAddMethod));
+        CLASS_ADD_ATTR(arrayClass, "get", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &arrayGet));
+        CLASS_ADD_ATTR(arrayClass, "set", DEF_BUILTIN_CFUNC_METHOD_VALUE(2, 0, &arraySet));
+        CLASS_ADD_ATTR(arrayClass, "size", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &arraySize));
+        CLASS_ADD_ATTR(arrayClass, "resize", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 0, &arrayResizeMethod));
+        CLASS_ADD_ATTR(arrayClass, "sum", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &arraySumMethod));
+        CLASS_ADD_ATTR(arrayClass, "dot", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &arrayDotMethod));
+        CLASS_ADD_ATTR(arrayClass, "min", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &arrayMinMethod));
+        CLASS_ADD_ATTR(arrayClass, "max", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 1, &arrayMaxMethod));
+        CLASS_ADD_ATTR(arrayClass, "scale", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 0, &arrayScaleMethod));
+        CLASS_ADD_ATTR(arrayClass, "sort", DEF_BUILTIN_CFUNC_METHOD_VALUE(0, 0, &arraySortMethod));
+        CLASS_ADD_ATTR(arrayClass, "map", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &arrayMap));
+        CLASS_ADD_ATTR(arrayClass, "_add", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &arrayAddOperator));
+        CLASS_ADD_ATTR(arrayClass, "_mul", DEF_BUILTIN_CFUNC_METHOD_VALUE(1, 1, &arrayMulOperator));
+    }
+
     // Builtin functions
     Value printFunc = DEF_BUILTIN_CFUNC_FUNCTION_VALUE(-1, 0, &print);
     addGlobalReference(globalRefTable, globalRefList, printFunc, "print");
@@ -22,7 +22,7 @@ valueArray* createValueArray(uint16_t size) {
     return array;
 }
 
-uint16_t addValToList(valueArray* array, Value obj) {
+uint32_t addValToList(valueArray* array, Value obj) {
     if (array->capacity <= array->count + 1) {
         array->capacity *= 2;
 
@@ -56,7 +56,7 @@ bool areValuesEqual(Value v1, Value v2) {
 }
 
 
-uint8_t addObj(valueArray* array, Value obj) {
+uint32_t addObj(valueArray* array, Value obj) {
     // Performs linear search for the object by its objID
     for (int i=0; i<array->count; i++) if (areValuesEqual(array->data[i], obj)) return i;
     // If not found, add the object to the array
@@ -79,9 +79,9 @@ Chunk* createChunk() {
     // Local ref array will be set after chunk compilation
     c->localRefArraySize = 0;
     c->code = malloc(c->capacity*sizeof(uint64_t));
-    c->lines = malloc(c->capacity*sizeof(uint16_t));
-    c->indices = malloc(c->capacity*sizeof(uint8_t));
-    c->sourceIndices = malloc(c->capacity*sizeof(uint8_t));
+    c->lines = malloc(c->capacity*sizeof(uint32_t));
+    c->indices = malloc(c->capacity*sizeof(uint16_t));
+    c->sourceIndices = malloc(c->capacity*sizeof(uint16_t));
     // Check if memory allocation succeeded
     if (c->code == NULL || c->lines == NULL || c->indices == NULL || c->sourceIndices == NULL) {
         compilationError(0, 0, 0, "Memory allocation failed.");
@@ -130,15 +130,15 @@ void internalWriteChunk32(Chunk* c, uint32_t data) {
     c->currIndexAtLine += 32;
 }
 
-void writeOp(Chunk* c, OpCode op, uint16_t line, uint8_t index, uint8_t sourceIndex) {
+void writeOp(Chunk* c, OpCode op, uint32_t line, uint16_t index, uint16_t sourceIndex) {
     // Check if the capacity is enough
     if (c->capacity <= c->count + 1) {
         c->capacity *= 2;
         // Temporary pointers for realloc results
         uint64_t* newCode = realloc(c->code, sizeof(uint64_t) * c->capacity);
-        uint16_t* newLines = realloc(c->lines, sizeof(uint16_t) * c->capacity);
-        uint8_t* newIndices = realloc(c->indices, sizeof(uint8_t) * c->capacity);
-        uint8_t* newSourceIndices = realloc(c->sourceIndices, sizeof(uint8_t) * c->capacity);
+        uint32_t* newLines = realloc(c->lines, sizeof(uint32_t) * c->capacity);
+        uint16_t* newIndices = realloc(c->indices, sizeof(uint16_t) * c->capacity);
+        uint16_t* newSourceIndices = realloc(c->sourceIndices, sizeof(uint16_t) * c->capacity);
 
         if (newCode == NULL || newLines == NULL || newIndices == NULL || newSourceIndices == NULL) {
             compilationError(0, 0, 0, "Memory allocation failed.");
@@ -163,15 +163,15 @@ void writeOp(Chunk* c, OpCode op, uint16_t line, uint8_t index, uint8_t sourceIn
     internalWriteChunk8(c, op);
 }
 
-void writeLine(Chunk* c, uint64_t data, uint16_t line, uint8_t index, uint8_t sourceIndex) {
+void writeLine(Chunk* c, uint64_t data, uint32_t line, uint16_t index, uint16_t sourceIndex) {
     // Check if the capacity is enough
     if (c->capacity <= c->count + 1) {
         c->capacity *= 2;
         // Temporary pointers for realloc results
         uint64_t* newCode = realloc(c->code, sizeof(uint64_t) * c->capacity);
-        uint16_t* newLines = realloc(c->lines, sizeof(uint16_t) * c->capacity);
-        uint8_t* newIndices = realloc(c->indices, sizeof(uint8_t) * c->capacity);
-        uint8_t* newSourceIndices = realloc(c->sourceIndices, sizeof(uint8_t) * c->capacity);
+        uint32_t* newLines = realloc(c->lines, sizeof(uint32_t) * c->capacity);
+        uint16_t* newIndices = realloc(c->indices, sizeof(uint16_t) * c->capacity);
+        uint16_t* newSourceIndices = realloc(c->sourceIndices, sizeof(uint16_t) * c->capacity);
 
         if (newCode == NULL || newLines == NULL || newIndices == NULL || newSourceIndices == NULL) {
             compilationError(0, 0, 0, "Memory allocation failed.");
@@ -213,35 +213,35 @@ void writeChunk32(Chunk* c, uint32_t data) {
 }
 
 void writeValConstant(Chunk* c, Value constant) {
-    internalWriteChunk8(c, addObj(c->constants, constant));
+    internalWriteChunk32(c, addObj(c->constants, constant));
 }
 
-uint16_t writeJump(Chunk* c, OpCode op, uint16_t line, uint8_t index, uint8_t sourceIndex) {
+uint32_t writeJump(Chunk* c, OpCode op, uint32_t line, uint16_t index, uint16_t sourceIndex) {
     // Write the jump instruction
     writeOp(c, op, line, index, sourceIndex);
     // Note the index of the jump instruction
-    uint16_t jumpAddrChunkIndex = c->count-1;
+    uint32_t jumpAddrChunkIndex = c->count-1;
     // Write the placeholder for the jump offset and carry over line & index number
-    internalWriteChunk16(c, 0);
+    internalWriteChunk32(c, 0);
     return jumpAddrChunkIndex;
 }
 
-void patchJump(Chunk* c, uint16_t chunkIndex, uint16_t jumpAddr) {
+void patchJump(Chunk* c, uint32_t chunkIndex, uint32_t jumpAddr) {
     // Directly patch the jump address into the chunk
     c->code[chunkIndex] |= ((uint64_t)jumpAddr << 8);
 }
 
-void patchJumpAtCurrent(Chunk* c, uint16_t chunkIndex) {
+void patchJumpAtCurrent(Chunk* c, uint32_t chunkIndex) {
     patchJump(c, chunkIndex, c->count);
 }
 
-void writeJumpBack(Chunk* c, OpCode op, uint16_t jumpAddr, uint16_t line, uint8_t index, uint8_t sourceIndex) {
+void writeJumpBack(Chunk* c, OpCode op, uint32_t jumpAddr, uint32_t line, uint16_t index, uint16_t sourceIndex) {
     // Write the jump instruction
     writeOp(c, op, line, index, sourceIndex);
-    internalWriteChunk16(c, jumpAddr);
+    internalWriteChunk32(c, jumpAddr);
 }
 
-Chunk* cropChunk(Chunk* c, uint16_t start) { // Copies chunk c from start to ending index and clears
+Chunk* cropChunk(Chunk* c, uint32_t start) { // Copies chunk c from start to ending index and clears
     // Create a new chunk
     Chunk* newChunk = createChunk();
     for (int i=start; i<c->count; i++) {
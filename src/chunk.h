@@ -53,12 +53,16 @@ typedef enum OpCode {
     OP_EXEC_FUNCTION_IGNORE_RETURN,
     OP_EXEC_METHOD_ENFORCE_RETURN,
     OP_EXEC_METHOD_IGNORE_RETURN,
+    OP_INVOKE_INTRINSIC_ENFORCE_RETURN,
+    OP_INVOKE_INTRINSIC_IGNORE_RETURN,
     OP_INIT, // Creates a new object, and push it to the stack with init function
     OP_GET_PARENT_INIT,
     OP_RETURN,
     OP_RETURN_NONE,
     OP_JUMP,
     OP_JUMP_IF_FALSE,
+    OP_ITER_INIT,
+    OP_ITER_NEXT,
 } OpCode;
 
 typedef enum specialAssignment {
@@ -71,6 +75,15 @@ typedef enum specialAssignment {
     ASSIGNMENT_POWER,
 } specialAssignment;
 
+// Builtin collection methods with a guarded fast path in the VM
+typedef enum intrinsicMethod {
+    INTRINSIC_NONE,
+    INTRINSIC_ADD,
+    INTRINSIC_GET,
+    INTRINSIC_SIZE,
+    INTRINSIC_CONTAINS,
+} intrinsicMethod;
+
 typedef struct objArray {
     int count;
     int capacity;
@@ -83,14 +96,14 @@ typedef struct Chunk {
     uint8_t currIndexAtLine; // Current index of the line within the 64 bits
     uint16_t localRefArraySize;
     uint64_t* code;
-    uint16_t* lines;
-    uint8_t* indices;
-    uint8_t* sourceIndices;
+    uint32_t* lines;
+    uint16_t* indices;
+    uint16_t* sourceIndices;
     valueArray* constants;
 } Chunk;
 
 valueArray* createValueArray(uint16_t size);
-uint16_t addValToList(valueArray* array, Value obj);
+uint32_t addValToList(valueArray* array, Value obj);
 
 bool areValuesEqual(Value v1, Value v2);
 void freeObjArray(valueArray* array);
@@ -102,16 +115,16 @@ void writeChunk4(Chunk* c, uint8_t data);
 void writeChunk8(Chunk* c, uint8_t data);
 void writeChunk16(Chunk* c, uint16_t data);
 void writeChunk32(Chunk* c, uint32_t data);
-void writeOp(Chunk* c, OpCode op, uint16_t line, uint8_t index, uint8_t sourceIndex);
-void writeLine(Chunk* c, uint64_t data, uint16_t line, uint8_t index, uint8_t sourceIndex);
+void writeOp(Chunk* c, OpCode op, uint32_t line, uint16_t index, uint16_t sourceIndex);
+void writeLine(Chunk* c, uint64_t data, uint32_t line, uint16_t index, uint16_t sourceIndex);
 
 void writeValConstant(Chunk* c, Value constant);
-uint16_t writeJump(Chunk* c, OpCode op, uint16_t line, uint8_t index, uint8_t sourceIndex);
-void patchJump(Chunk* c, uint16_t chunkIndex, uint16_t jumpAddr);
-void patchJumpAtCurrent(Chunk* c, uint16_t chunkIndex);
-void writeJumpBack(Chunk* c, OpCode op, uint16_t jumpAddr, uint16_t line, uint8_t index, uint8_t sourceIndex);
+uint32_t writeJump(Chunk* c, OpCode op, uint32_t line, uint16_t index, uint16_t sourceIndex);
+void patchJump(Chunk* c, uint32_t chunkIndex, uint32_t jumpAddr);
+void patchJumpAtCurrent(Chunk* c, uint32_t chunkIndex);
+void writeJumpBack(Chunk* c, OpCode op, uint32_t jumpAddr, uint32_t line, uint16_t index, uint16_t sourceIndex);
 
-Chunk* cropChunk(Chunk* c, uint16_t start);
+Chunk* cropChunk(Chunk* c, uint32_t start);
 void copyChunk(Chunk* main, Chunk* addChunk); // Adds addChunk to main chunk
 
 #endif //CJ_2_CHUNK_H
@@ -11,11 +11,19 @@
 
 #define OBJECT_ATTR_TABLE_INIT_SIZE 8
 #define CLASS_ATTR_TABLE_INIT_SIZE 8
+#define SYMBOL_TABLE_INIT_SIZE 64
+
+// Object shapes
+#define SHAPE_TRANSITION_INIT_SIZE 2
+// Objects switch to dictionary mode past either limit
+#define SHAPE_MAX_SLOT_COUNT 32
+#define SHAPE_MAX_TRANSITION_COUNT 16
 
 #define CHUNK_INIT_SIZE 16
 #define OBJ_ARRAY_INIT_SIZE 8
 
-#define MAX_CLASS_NUM 256
+// Class IDs are stored as the 16-bit Value type
+#define MAX_CLASS_NUM 65536
 
 #define EXECUTE_CHUNK
 
@@ -26,8 +34,12 @@
 // Runtime DS
 
 #define RUNTIME_LIST_INIT_SIZE 8
+#define RUNTIME_ARRAY_INIT_SIZE 8
 #define RUNTIME_DICT_INIT_SIZE 8
 #define RUNTIME_SET_INIT_SIZE 8
+// Sets of integers below this stay bitsets while they use at most SET_BITSET_DENSITY bits per element
+#define SET_BITSET_MAX_SIZE 65536
+#define SET_BITSET_DENSITY 64
 
 // VM
 #define GLOBAL_REF_TABLE_INIT_SIZE 8
@@ -41,7 +53,8 @@
 #define CONTINUE_JUMP_LIST_INIT_SIZE 32
 #define BREAK_JUMP_LIST_INIT_SIZE 32
 #define INCLUDE_STACK_SIZE 32
-#define MAX_SOURCE_SIZE 128
+#define CHUNK_SET_INDEX_ARRAY_INIT_SIZE 64
+#define MAX_SOURCE_SIZE 1024
 #define OPTIMIZE_OPERATION_PAYLOAD
 #define EXCEPTION_ARRAY_SIZE 256
 #define HANDLER_ARRAY_SIZE 32
@@ -58,10 +71,21 @@
 #define CONST_BLOCK_SIZE 32
 
 // Runtime Memory Management
-#define RUNTIME_BLOCK_SIZE 64
+// Blocks are RUNTIME_BLOCK_BYTES aligned slices of GC_ARENA_SIZE aligned arenas, both powers of two
+#define RUNTIME_BLOCK_BYTES 16384
+#define GC_ARENA_SIZE (2 * 1024 * 1024)
+// Object slots per block, fills RUNTIME_BLOCK_BYTES together with the block's bitmaps
+#define RUNTIME_BLOCK_SIZE 960
+// Back arenas with transparent huge pages, freed blocks then keep their memory
+//#define GC_ARENA_HUGE_PAGES
 #define INITIAL_PRIORITY_QUEUE_CAPACITY 10
 #define PRIORITY_QUEUE_GROWTH_FACTOR 2
 #define MAX_ALLOWED_EMPTY_BLOCK 1
+#define REMEMBERED_SET_INIT_SIZE 64
+#define BLOCK_TABLE_INIT_SIZE 64
+#define GRAY_STACK_INIT_SIZE 256
+// Values ahead of the one being marked whose object header is prefetched
+#define GC_PREFETCH_DISTANCE 8
 //#define PRINT_MEMORY_INFO
 //#define PRINT_BLOCK_ORDER
 
@@ -69,7 +93,30 @@
 //#define PRINT_ERROR_OP
 
 // GC
+// Objects allocated between minor collections
+#define GC_NURSERY_SIZE 8192
+// Old objects needed before the first major collection, later the old object count after a major collection times the growth factor
+#define GC_MAJOR_MIN_THRESHOLD 65536
+#define GC_MAJOR_GROWTH_FACTOR 2
+// Major collections mark and sweep in slices, one slice every GC_INCREMENTAL_STEP_SIZE allocations
+#define GC_INCREMENTAL_STEP_SIZE 256
+// Objects traced or swept per allocation, must stay above 1 so a cycle finishes
+#define GC_INCREMENTAL_WORK_RATIO 4
+// Maximum pause of a slice in microseconds, a slice always does at least GC_INCREMENTAL_STEP_SIZE units of work
+#define GC_MAX_PAUSE_US 500
+// Mark the old generation in a forked process instead of on the interpreter thread
+//#define GC_CONCURRENT_MARK
+// Run major collections stop-the-world on this many threads, takes precedence over the options above
+//#define GC_PARALLEL_THREADS 4
+// Gray objects a worker keeps before handing half of them to idle workers
+#define GC_PARALLEL_SHARE_THRESHOLD 32
 //#define PRINT_GC_INFO
 //#define PRINT_GC_REMOVAL
 
+// Slab allocator for runtime data structures
+#define SLAB_PAGE_SIZE (64 * 1024)
+// Empty pages a size class keeps instead of returning them to malloc
+#define SLAB_MAX_EMPTY_PAGES 1
+//#define PRINT_SLAB_USAGE
+
 #endif //CJ_2_COMMON_H
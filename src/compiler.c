@@ -23,8 +23,14 @@
 
 #define GET_BYTE(data, shift)  ((uint8_t) (((data) >> ((shift) * 8)) & 0xFF))
 #define GET_WORD(data, shift) ((uint16_t)(((data) >> ((shift) * 8)) & 0xFFFF))
+#define GET_DWORD(data, shift) ((uint32_t)(((data) >> ((shift) * 8)) & 0xFFFFFFFF))
 #define SET_BOTTOM_8_BITS(data, byteVal)  (((data) & 0xFFFFFFFFFFFFFF00) | (uint64_t)(byteVal))
 
+// Local assignment bit sets
+#define REF_SET_WORDS(size) (((size) + 63) / 64)
+#define REF_SET_HAS(set, index) (((set)[(index) / 64] >> ((index) % 64)) & 1ULL)
+#define REF_SET_ADD(set, index) ((set)[(index) / 64] |= (1ULL << ((index) % 64)))
+
 
 refTable* globalRefTable = NULL;
 runtimeList* globalRefList = NULL;
@@ -52,14 +58,24 @@ bool isMethodChunk;
 bool isInitMethodChunk;
 
 // Temporary placeholder jump list
-uint16_t* continueJumpList;
-uint16_t* breakJumpList;
+uint32_t* continueJumpList;
+uint32_t* breakJumpList;
 uint8_t continueJumpIndex;
 uint8_t breakJumpIndex;
 
 // Chunk set local ref arrays
-uint16_t chunkSetIndexArray[512];
-uint16_t chunkSetIndexArrayIndex;
+uint16_t* chunkSetIndexArray = NULL;
+uint32_t chunkSetIndexArrayIndex;
+uint32_t chunkSetIndexArrayCapacity;
+// Number of leading chunkSetIndexArray entries assigned on entry (self & arguments)
+uint32_t chunkParamCount;
+
+// Current for-each nesting depth, used to allocate hidden iterator slots
+uint16_t forEachDepth;
+
+// Intrinsic method named by the preceding '.', consumed by the following call
+intrinsicMethod pendingIntrinsic;
+uint32_t pendingIntrinsicSymbol;
 
 // Optimization for left hand size binary number operation
 captureType capturedOperand;
@@ -99,7 +115,136 @@ void setCurrentChunk(Chunk* chunk) {
     if (currentChunk != NULL || currentLocalRefTable != NULL) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Unclosed chunk or refTable");
     currentChunk = chunk;
     currentLocalRefTable = createRefTable(LOCAL_REF_TABLE_INIT_SIZE);
+    if (chunkSetIndexArray == NULL) {
+        chunkSetIndexArrayCapacity = CHUNK_SET_INDEX_ARRAY_INIT_SIZE;
+        chunkSetIndexArray = malloc(sizeof(uint16_t) * chunkSetIndexArrayCapacity);
+        if (chunkSetIndexArray == NULL) compilationError(0, 0, 0, "Memory allocation failed.");
+    }
     chunkSetIndexArrayIndex = 0;
+    chunkParamCount = 0;
+    forEachDepth = 0;
+}
+
+// Notes a local ref index assigned within the current chunk
+void addChunkSetIndex(uint32_t localIndex) {
+    if (chunkSetIndexArrayIndex >= chunkSetIndexArrayCapacity) {
+        chunkSetIndexArrayCapacity *= 2;
+        uint16_t* newArray = realloc(chunkSetIndexArray, sizeof(uint16_t) * chunkSetIndexArrayCapacity);
+        if (newArray == NULL) compilationError(0, 0, 0, "Memory allocation failed.");
+        chunkSetIndexArray = newArray;
+    }
+    chunkSetIndexArray[chunkSetIndexArrayIndex++] = localIndex;
+}
+
+// Merges an incoming assignment state into the state of target, returns true if the target state changed
+static bool mergeRefState(uint64_t* mustIn, uint64_t* mayIn, bool* reached, uint32_t words, uint32_t target, const uint64_t* must, const uint64_t* may) {
+    if (target >= currentChunk->count) return false;
+    uint64_t* targetMust = &mustIn[target * words];
+    uint64_t* targetMay = &mayIn[target * words];
+    if (!reached[target]) {
+        reached[target] = true;
+        memcpy(targetMust, must, sizeof(uint64_t) * words);
+        memcpy(targetMay, may, sizeof(uint64_t) * words);
+        return true;
+    }
+    bool changed = false;
+    for (uint32_t w=0; w<words; w++) {
+        uint64_t newMust = targetMust[w] & must[w];
+        uint64_t newMay = targetMay[w] | may[w];
+        if (newMust != targetMust[w] || newMay != targetMay[w]) changed = true;
+        targetMust[w] = newMust;
+        targetMay[w] = newMay;
+    }
+    return changed;
+}
+
+// Definite assignment analysis, resolves combined references to pure local or global references where possible
+static void resolveCombinedRefs(uint32_t localRefSize) {
+    uint32_t count = currentChunk->count;
+    if (count == 0 || localRefSize == 0) return;
+    uint32_t words = REF_SET_WORDS(localRefSize);
+    // Locals assigned on all paths (must) and on any path (may) prior to each instruction
+    uint64_t* mustIn = calloc(count * words, sizeof(uint64_t));
+    uint64_t* mayIn = calloc(count * words, sizeof(uint64_t));
+    uint64_t* must = malloc(sizeof(uint64_t) * words);
+    uint64_t* may = malloc(sizeof(uint64_t) * words);
+    uint64_t* allLocals = malloc(sizeof(uint64_t) * words);
+    bool* reached = calloc(count, sizeof(bool));
+    if (mustIn == NULL || mayIn == NULL || must == NULL || may == NULL || allLocals == NULL || reached == NULL) compilationError(0, 0, 0, "Memory allocation failed.");
+    for (uint32_t w=0; w<words; w++) allLocals[w] = ~0ULL;
+    // Self & arguments are assigned on entry
+    for (uint32_t i=0; i<chunkParamCount; i++) {
+        REF_SET_ADD(mustIn, chunkSetIndexArray[i]);
+        REF_SET_ADD(mayIn, chunkSetIndexArray[i]);
+    }
+    reached[0] = true;
+    // Iterate to fixed point
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint32_t i=0; i<count; i++) {
+            if (!reached[i]) continue;
+            uint64_t line = currentChunk->code[i];
+            OpCode op = (uint8_t)(line & 0xFF);
+            memcpy(must, &mustIn[i * words], sizeof(uint64_t) * words);
+            memcpy(may, &mayIn[i * words], sizeof(uint64_t) * words);
+            // Only plain assignments write the local, special assignments fall back to the global when the local is unset
+            if ((op == OP_SET_COMBINED_REF_ATTR && GET_BYTE(line, 7) == ASSIGNMENT_NONE) || (op == OP_SET_LOCAL_REF_ATTR && GET_BYTE(line, 3) == ASSIGNMENT_NONE)) {
+                REF_SET_ADD(must, GET_WORD(line, 1));
+                REF_SET_ADD(may, GET_WORD(line, 1));
+            }
+            switch (op) {
+                case OP_JUMP:
+                    changed |= mergeRefState(mustIn, mayIn, reached, words, GET_DWORD(line, 1), must, may);
+                    break;
+                case OP_JUMP_IF_FALSE:
+                case OP_ITER_NEXT:
+                    changed |= mergeRefState(mustIn, mayIn, reached, words, GET_DWORD(line, 1), must, may);
+                    changed |= mergeRefState(mustIn, mayIn, reached, words, i + 1, must, may);
+                    break;
+                case OP_SET_HANDLER:
+                case OP_SET_ALL_HANDLER:
+                    // Handler may be entered after any later assignment, but never before this point
+                    changed |= mergeRefState(mustIn, mayIn, reached, words, GET_DWORD(line, 2), must, allLocals);
+                    changed |= mergeRefState(mustIn, mayIn, reached, words, i + 1, must, may);
+                    break;
+                case OP_RETURN:
+                case OP_RETURN_NONE:
+                    break;
+                default:
+                    changed |= mergeRefState(mustIn, mayIn, reached, words, i + 1, must, may);
+            }
+        }
+    }
+    // Rewrite combined references
+    for (uint32_t i=0; i<count; i++) {
+        if (!reached[i]) continue;
+        uint64_t* currentCode = &currentChunk->code[i];
+        OpCode op = (uint8_t)(*currentCode & 0xFF);
+        if (op != OP_GET_COMBINED_REF_ATTR && op != OP_SET_COMBINED_REF_ATTR) continue;
+        uint16_t localIndex = GET_WORD(*currentCode, 1);
+        uint32_t globalIndex = GET_DWORD(*currentCode, 3);
+        uint8_t sa = GET_BYTE(*currentCode, 7);
+        bool isLocal = REF_SET_HAS(&mustIn[i * words], localIndex) || (op == OP_SET_COMBINED_REF_ATTR && sa == ASSIGNMENT_NONE);
+        bool isGlobal = !REF_SET_HAS(&mayIn[i * words], localIndex);
+        if (!isLocal && !isGlobal) continue;
+        // Clear all operands
+        *currentCode &= 0xFFULL;
+        if (op == OP_GET_COMBINED_REF_ATTR) {
+            *currentCode = SET_BOTTOM_8_BITS(*currentCode, isLocal ? OP_GET_LOCAL_REF_ATTR : OP_GET_GLOBAL_REF_ATTR);
+            *currentCode |= ((uint64_t)(isLocal ? localIndex : globalIndex) << 8);
+        } else {
+            *currentCode = SET_BOTTOM_8_BITS(*currentCode, isLocal ? OP_SET_LOCAL_REF_ATTR : OP_SET_GLOBAL_REF_ATTR);
+            *currentCode |= ((uint64_t)(isLocal ? localIndex : globalIndex) << 8);
+            *currentCode |= ((uint64_t)sa << (isLocal ? 24 : 40));
+        }
+    }
+    free(mustIn);
+    free(mayIn);
+    free(must);
+    free(may);
+    free(allLocals);
+    free(reached);
 }
 
 void clearCurrentChunk() {
@@ -113,6 +258,8 @@ void clearCurrentChunk() {
     printf("\n");
 #endif
     uint32_t localRefSize = currentLocalRefTable->numEntries;
+    // Local ref indices are 16-bit operands
+    if (localRefSize > UINT16_MAX) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Too many local references in callable");
 #ifdef DEBUG_PRINT_LOCAL_REF_TABLE
     printf("Local ref table: ");
     printRefTable(currentLocalRefTable);
@@ -121,6 +268,8 @@ void clearCurrentChunk() {
     // Free local ref table
     freeRefTable(currentLocalRefTable);
     currentLocalRefTable = NULL;
+    // Resolve combined references
+    resolveCombinedRefs(localRefSize);
     // Compiler optimization for invalid local get operations
     int* localIndexArray = malloc(sizeof(int) * localRefSize);
     int frontShift = 0;
@@ -148,10 +297,10 @@ void clearCurrentChunk() {
                 // Change opcode to OP_GET_GLOBAL_REF_ATTR
                 currentChunk->code[i] = SET_BOTTOM_8_BITS(currentChunk->code[i], OP_GET_GLOBAL_REF_ATTR);
                 // Get global ref index
-                uint16_t globalIndex = (uint16_t)((currentChunk->code[i] >> (3 * 8)) & 0xFFFF);
-                // Clear the next 16 bits after the 8-bit opcode
-                currentChunk->code[i] &= ~(0xFFFFULL << 8);
-                // Set the next 16 bits to the new mapped index
+                uint32_t globalIndex = GET_DWORD(currentChunk->code[i], 3);
+                // Clear all operands after the 8-bit opcode
+                currentChunk->code[i] &= 0xFFULL;
+                // Set the next 32 bits to the global index
                 currentChunk->code[i] |= ((uint64_t)globalIndex << 8);
             } else {
                 // Clear the next 16 bits after the 8-bit opcode
@@ -159,12 +308,18 @@ void clearCurrentChunk() {
                 // Set the next 16 bits to the new mapped index
                 currentChunk->code[i] |= ((uint64_t)localIndexArray[localIndex] << 8);
             }
-        } else if (op == OP_SET_COMBINED_REF_ATTR) {
+        } else if (op == OP_SET_COMBINED_REF_ATTR || op == OP_GET_LOCAL_REF_ATTR || op == OP_SET_LOCAL_REF_ATTR) {
             uint16_t localIndex = (uint16_t)((currentChunk->code[i] >> (1 * 8)) & 0xFFFF);
             // Clear the next 16 bits after the 8-bit opcode
             currentChunk->code[i] &= ~(0xFFFFULL << 8);
             // Set the next 16 bits to the new mapped index
             currentChunk->code[i] |= ((uint64_t)localIndexArray[localIndex] << 8);
+        } else if (op == OP_ITER_INIT || op == OP_ITER_NEXT) {
+            // Iterator slot index is stored after the jump offset for OP_ITER_NEXT
+            uint8_t shift = op == OP_ITER_INIT ? 1 : 5;
+            uint16_t localIndex = GET_WORD(currentChunk->code[i], shift);
+            currentChunk->code[i] &= ~(0xFFFFULL << (shift * 8));
+            currentChunk->code[i] |= ((uint64_t)localIndexArray[localIndex] << (shift * 8));
         }
     }
     // Free
@@ -175,13 +330,13 @@ void clearCurrentChunk() {
     for (int i=0; i<currentChunk->count; i++) {
         uint64_t* currentCode = &currentChunk->code[i];
         OpCode op = (uint8_t)(currentChunk->code[i] & 0xFF);
-        if (op == OP_JUMP || op == OP_JUMP_IF_FALSE) {
-            uint16_t jumpAddr = GET_WORD(*currentCode, 1);
-            int16_t jumpAddrDiff = (int16_t) (jumpAddr - i);
-            // Clear the next 16 bits after the 8-bit opcode
-            *currentCode &= ~(0xFFFFULL << 8);
-            // Set the next 16 bits to the new mapped index
-            *currentCode |= ((int64_t)jumpAddrDiff << 8);
+        if (op == OP_JUMP || op == OP_JUMP_IF_FALSE || op == OP_ITER_NEXT) {
+            uint32_t jumpAddr = GET_DWORD(*currentCode, 1);
+            int32_t jumpAddrDiff = (int32_t) (jumpAddr - i);
+            // Clear the next 32 bits after the 8-bit opcode
+            *currentCode &= ~(0xFFFFFFFFULL << 8);
+            // Set the next 32 bits to the relative jump offset
+            *currentCode |= ((uint64_t)(uint32_t)jumpAddrDiff << 8);
         }
     }
 #ifdef DEBUG_PRINT_CHUNK_AFTER_CREATION
@@ -204,7 +359,7 @@ Value createStringConst(char* str) {
     return builtinVal;
 }
 
-uint16_t getGlobalRefIndex(char* identifier) {
+uint32_t getGlobalRefIndex(char* identifier) {
     if (globalRefTable == NULL || globalRefList == NULL) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Null global refTable or refList");
     if (refTableContains(globalRefTable, identifier)) return getRefIndex(globalRefTable, identifier);
     // Add to refTable
@@ -212,7 +367,7 @@ uint16_t getGlobalRefIndex(char* identifier) {
     return getRefIndex(globalRefTable, identifier);
 }
 
-void patchContinueJumps(uint16_t jumpAddr) {
+void patchContinueJumps(uint32_t jumpAddr) {
     for (int i=0; i<continueJumpIndex; i++) patchJump(currentChunk, continueJumpList[i], jumpAddr);
 }
 
@@ -294,6 +449,8 @@ ParseRule rules[] = {
         [KEYWORD_HANDLE]      = {NULL, NULL, PREC_NONE},
         [KEYWORD_TRY]         = {NULL, NULL, PREC_NONE},
         [KEYWORD_RAISE]       = {NULL, NULL, PREC_NONE},
+        [KEYWORD_IN]          = {NULL, NULL, PREC_NONE},
+        [KEYWORD_IMMUTABLE]   = {NULL, NULL, PREC_NONE},
         [KEYWORD_EXCEPTION]   = {NULL, NULL, PREC_NONE},
         [KEYWORD_UNRECOVERABLE] = {NULL, NULL, PREC_NONE},
 
@@ -329,10 +486,21 @@ void grouping(bool enforceReturn) {
 
 void methodCall(bool enforceReturn) {
     token* callToken = getPrevToken();
+    // Claim pending intrinsic before arguments may set their own
+    intrinsicMethod intrinsic = pendingIntrinsic;
+    uint32_t intrinsicSymbol = pendingIntrinsicSymbol;
+    pendingIntrinsic = INTRINSIC_NONE;
     uint8_t argCount = parseCommaSequence(RIGHT_PARENTHESES);
     incCheckNull();
-    WRITEOP_CURRENT_CHUNK(enforceReturn ? OP_EXEC_METHOD_ENFORCE_RETURN : OP_EXEC_METHOD_IGNORE_RETURN, callToken->line, callToken->index, callToken->sourceIndex);
-    writeChunk8(currentChunk, argCount);
+    if (intrinsic != INTRINSIC_NONE) {
+        WRITEOP_CURRENT_CHUNK(enforceReturn ? OP_INVOKE_INTRINSIC_ENFORCE_RETURN : OP_INVOKE_INTRINSIC_IGNORE_RETURN, callToken->line, callToken->index, callToken->sourceIndex);
+        writeChunk32(currentChunk, intrinsicSymbol);
+        writeChunk8(currentChunk, argCount);
+        writeChunk8(currentChunk, intrinsic);
+    } else {
+        WRITEOP_CURRENT_CHUNK(enforceReturn ? OP_EXEC_METHOD_ENFORCE_RETURN : OP_EXEC_METHOD_IGNORE_RETURN, callToken->line, callToken->index, callToken->sourceIndex);
+        writeChunk8(currentChunk, argCount);
+    }
     emittedCall = true;
 }
 
@@ -391,14 +559,31 @@ void string(bool enforceReturn) {
     writeValConstant(currentChunk, createStringConst(TOKEN_VALUE(stringToken)));
 }
 
+static intrinsicMethod getIntrinsicMethod(uint32_t symbol) {
+    switch (symbol) {
+        case SYMBOL_ADD: return INTRINSIC_ADD;
+        case SYMBOL_GET: return INTRINSIC_GET;
+        case SYMBOL_SIZE: return INTRINSIC_SIZE;
+        case SYMBOL_CONTAINS: return INTRINSIC_CONTAINS;
+        default: return INTRINSIC_NONE;
+    }
+}
+
 void dot(bool enforceReturn) {
     token* dotToken = getPrevToken();
     if (TOKEN_TYPE(currentToken) != IDENTIFIER) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Expected identifier after '.'");
-    Value attrName = createStringConst(TOKEN_VALUE(currentToken));
+    uint32_t attrSymbol = internSymbol(TOKEN_VALUE(currentToken));
+    intrinsicMethod intrinsic = getIntrinsicMethod(attrSymbol);
     incCheckNull();
+    // Builtin collection methods defer attribute lookup to the intrinsic call
+    if (TOKEN_TYPE(currentToken) == LEFT_PARENTHESES && intrinsic != INTRINSIC_NONE) {
+        pendingIntrinsic = intrinsic;
+        pendingIntrinsicSymbol = attrSymbol;
+        return;
+    }
     // Check if the next token is a call token
     WRITEOP_CURRENT_CHUNK(TOKEN_TYPE(currentToken) == LEFT_PARENTHESES ? OP_GET_ATTR_CALL : OP_GET_ATTR, dotToken->line, dotToken->index, dotToken->sourceIndex);
-    writeValConstant(currentChunk, attrName);
+    writeChunk32(currentChunk, attrSymbol);
 }
 
 void binary(bool enforceReturn) {
@@ -592,7 +777,7 @@ void unary(bool enforceReturn) {
     if (TOKEN_TYPE(prevToken) == KEYWORD_GLOBAL) {
         if (TOKEN_TYPE(currentToken) != IDENTIFIER) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Expected identifier after 'global'");
         WRITEOP_CURRENT_CHUNK(OP_GET_GLOBAL_REF_ATTR, prevToken->line, prevToken->index, prevToken->sourceIndex);
-        writeChunk16(currentChunk, getGlobalRefIndex(TOKEN_VALUE(currentToken)));
+        writeChunk32(currentChunk, getGlobalRefIndex(TOKEN_VALUE(currentToken)));
         incCheckNull();
         return;
     }
@@ -700,8 +885,8 @@ void functionCall(bool enforceReturn) {
     incCheckNull();
     WRITEOP_CURRENT_CHUNK(enforceReturn ? OP_EXEC_FUNCTION_ENFORCE_RETURN : OP_EXEC_FUNCTION_IGNORE_RETURN, callToken->line, callToken->index, callToken->sourceIndex);
     writeChunk8(currentChunk, argCount);
-    uint16_t functionIndex = getRefIndex(prelinkedFuncTable, TOKEN_VALUE(functionToken));
-    writeChunk16(currentChunk, functionIndex);
+    uint32_t functionIndex = getRefIndex(prelinkedFuncTable, TOKEN_VALUE(functionToken));
+    writeChunk32(currentChunk, functionIndex);
     // Add to prelinked call list
     preLinkedCallNode* node = malloc(sizeof(preLinkedCallNode));
     node->command = currentChunk->code[currentChunk->count-1];
@@ -723,7 +908,7 @@ void getVar(bool enforceReturn) {
                 // Write local ref array index
                 writeChunk16(currentChunk, getRefIndex(currentLocalRefTable, TOKEN_VALUE(prevToken)));
                 // Write global ref array index
-                writeChunk16(currentChunk, getGlobalRefIndex(TOKEN_VALUE(prevToken)));
+                writeChunk32(currentChunk, getGlobalRefIndex(TOKEN_VALUE(prevToken)));
             }
             break;
         }
@@ -802,10 +987,10 @@ OpCode swapEndOp(OpCode op) {
 
 uint8_t opArgCount(OpCode op) {
     switch (op) {
-        case OP_GET_GLOBAL_REF_ATTR: return 2;
-        case OP_GET_COMBINED_REF_ATTR: return 4;
+        case OP_GET_GLOBAL_REF_ATTR: return 4;
+        case OP_GET_COMBINED_REF_ATTR: return 6;
         case OP_GET_INDEX_REF: return 0;
-        case OP_GET_ATTR: return 1;
+        case OP_GET_ATTR: return 4;
         default:
             compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Invalid end operation swap");
             return 0;
@@ -864,7 +1049,7 @@ void assignment() {
     endLine |= ((uint64_t)specialAssignment << ((argCount + 1)*8));
     if (endOp == OP_GET_COMBINED_REF_ATTR) {
         // Add to chunk set index for compiler optimization
-        chunkSetIndexArray[chunkSetIndexArrayIndex++] = (uint16_t)((endLine >> (1 * 8)) & 0xFFFF);
+        addChunkSetIndex(GET_WORD(endLine, 1));
     }
     // Write to chunk
     writeLine(currentChunk, endLine, assignmentToken->line, assignmentToken->index, assignmentToken->sourceIndex);
@@ -909,7 +1094,7 @@ void ifStatement() {
     incCheckType(LEFT_BRACE, "Expected '{' after condition");
     incCheckNull();
     // Create jump
-    uint16_t jumpNextConditionChunkIndex = writeJump(currentChunk, OP_JUMP_IF_FALSE, ifToken->line, ifToken->index, ifToken->sourceIndex);
+    uint32_t jumpNextConditionChunkIndex = writeJump(currentChunk, OP_JUMP_IF_FALSE, ifToken->line, ifToken->index, ifToken->sourceIndex);
     // Parse if body
     while (TOKEN_TYPE(currentToken) != RIGHT_BRACE) statement();
     // Load function body
@@ -920,7 +1105,7 @@ void ifStatement() {
         case KEYWORD_ELIF:
         case KEYWORD_ELSE: {
             // Create end of body jump to skip else body
-            uint16_t jumpEndChunkIndex = writeJump(currentChunk, OP_JUMP, ifToken->line, ifToken->index, ifToken->sourceIndex);
+            uint32_t jumpEndChunkIndex = writeJump(currentChunk, OP_JUMP, ifToken->line, ifToken->index, ifToken->sourceIndex);
             // Patch the condition jump
             patchJumpAtCurrent(currentChunk, jumpNextConditionChunkIndex);
             if (TOKEN_TYPE(currentToken) == KEYWORD_ELIF) {
@@ -946,13 +1131,13 @@ void whileStatement() {
     incCheckNull();
 
     // Note expression start location
-    uint16_t expressionStartChunkIndex = CURR_CHUNK_INDEX;
+    uint32_t expressionStartChunkIndex = CURR_CHUNK_INDEX;
 
     // Parse condition
     expression(true);
 
     // Add jump if false instruction
-    uint16_t jumpEndChunkIndex = writeJump(currentChunk, OP_JUMP_IF_FALSE, whileToken->line, whileToken->index, whileToken->sourceIndex);
+    uint32_t jumpEndChunkIndex = writeJump(currentChunk, OP_JUMP_IF_FALSE, whileToken->line, whileToken->index, whileToken->sourceIndex);
 
     // Check formatting
     checkType(RIGHT_PARENTHESES, "Expected ')' after condition");
@@ -960,14 +1145,14 @@ void whileStatement() {
     incCheckNull();
 
     // Store previous jump list pointers
-    uint16_t* prevContinueJumpList = continueJumpList;
-    uint16_t* prevBreakJumpList = breakJumpList;
+    uint32_t* prevContinueJumpList = continueJumpList;
+    uint32_t* prevBreakJumpList = breakJumpList;
     uint8_t prevContinueJumpIndex = continueJumpIndex;
     uint8_t prevBreakJumpIndex = breakJumpIndex;
 
     // Create new jump list pointers
-    continueJumpList = malloc(sizeof(uint16_t) * CONTINUE_JUMP_LIST_INIT_SIZE);
-    breakJumpList = malloc(sizeof(uint16_t) * BREAK_JUMP_LIST_INIT_SIZE);
+    continueJumpList = malloc(sizeof(uint32_t) * CONTINUE_JUMP_LIST_INIT_SIZE);
+    breakJumpList = malloc(sizeof(uint32_t) * BREAK_JUMP_LIST_INIT_SIZE);
     continueJumpIndex = 0;
     breakJumpIndex = 0;
 
@@ -999,7 +1184,7 @@ void whileStatement() {
     patchJumpAtCurrent(currentChunk, jumpEndChunkIndex);
 }
 
-uint8_t handleStatement(handlerNode* headNode, uint32_t offset, uint16_t* jumpToEndSlot, uint16_t* handlerChunkStartSlot, token** handlerTokenSlot) {
+uint8_t handleStatement(handlerNode* headNode, uint32_t offset, uint32_t* jumpToEndSlot, uint32_t* handlerChunkStartSlot, token** handlerTokenSlot) {
     incCheckNull();
     uint8_t argCount = 0;
     if (TOKEN_TYPE(currentToken) == LEFT_PARENTHESES) {
@@ -1036,13 +1221,13 @@ uint8_t handleStatement(handlerNode* headNode, uint32_t offset, uint16_t* jumpTo
 
 void exceptionHandlerStatement() {
     // Add beginning jump
-    uint16_t jumpBeginningChunkIndex = writeJump(currentChunk, OP_JUMP, currentToken->line, currentToken->index, currentToken->sourceIndex);
+    uint32_t jumpBeginningChunkIndex = writeJump(currentChunk, OP_JUMP, currentToken->line, currentToken->index, currentToken->sourceIndex);
     uint8_t currArgCount;
 
     // Create handler array
     handlerNode handlerArray[HANDLER_ARRAY_SIZE];
-    uint16_t handlerJumpToEndArray[HANDLER_ARRAY_SIZE];
-    uint16_t handlerChunkStartIndexArray[HANDLER_ARRAY_SIZE];
+    uint32_t handlerJumpToEndArray[HANDLER_ARRAY_SIZE];
+    uint32_t handlerChunkStartIndexArray[HANDLER_ARRAY_SIZE];
     token* handlerTokenArray[HANDLER_ARRAY_SIZE];
     for (uint32_t i = 0; i < HANDLER_ARRAY_SIZE; i++) handlerArray[i].errorType = EXCEPTION_ARRAY_SIZE;
     uint32_t handlerIndex = 0;
@@ -1070,13 +1255,13 @@ void exceptionHandlerStatement() {
         tempToken = handlerTokenArray[0];
         writeOp(currentChunk, OP_SET_ALL_HANDLER, tempToken->line, tempToken->index, tempToken->sourceIndex);
         writeChunk8(currentChunk, handlerIndex);
-        writeChunk16(currentChunk, handlerChunkStartIndexArray[0]);
+        writeChunk32(currentChunk, handlerChunkStartIndexArray[0]);
     } else {
         for (uint32_t i = 0; i < handlerIndex; i++) {
             tempToken = handlerTokenArray[i];
             writeOp(currentChunk, OP_SET_HANDLER, tempToken->line, tempToken->index, tempToken->sourceIndex);
             writeChunk8(currentChunk, handlerIndex);
-            writeChunk16(currentChunk, handlerChunkStartIndexArray[i]);
+            writeChunk32(currentChunk, handlerChunkStartIndexArray[i]);
             writeChunk16(currentChunk, handlerArray[i].errorType);
         }
     }
@@ -1138,27 +1323,114 @@ void standardStatement() {
     }
 }
 
+// Reserves contiguous hidden local slots for iterator state (collection, cursor)
+uint16_t reserveIteratorSlots() {
+    char slotName[IDENTIFIER_BUFFER_SIZE];
+    uint16_t baseSlot = 0;
+    for (uint16_t i=0; i<2; i++) {
+        snprintf(slotName, sizeof(slotName), "#iter%u.%u", forEachDepth, i);
+        bool isNewSlot = !refTableContains(currentLocalRefTable, slotName);
+        // Slot names cannot collide with identifiers, reuse slots across sibling loops
+        uint16_t slot = getRefIndex(currentLocalRefTable, isNewSlot ? addReference(slotName) : slotName);
+        if (isNewSlot) addChunkSetIndex(slot);
+        if (i == 0) baseSlot = slot;
+        else if (slot != baseSlot + i) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Non-contiguous iterator slots");
+    }
+    return baseSlot;
+}
+
+void forEachStatement(token* forToken) {
+    token* varToken = currentToken;
+    // Skip identifier and 'in'
+    incCheckType(KEYWORD_IN, "Expected 'in' after for-each variable");
+    incCheckNull();
+    // Parse collection
+    expression(true);
+    // Check formatting
+    checkType(RIGHT_PARENTHESES, "Expected ')' after for-each collection");
+    incCheckType(LEFT_BRACE, "Expected '{' after for-each collection");
+    incCheckNull();
+    // Initialize iterator
+    uint16_t iteratorSlot = reserveIteratorSlots();
+    WRITEOP_CURRENT_CHUNK(OP_ITER_INIT, forToken->line, forToken->index, forToken->sourceIndex);
+    writeChunk16(currentChunk, iteratorSlot);
+    // Note loop start location
+    uint32_t loopStartChunkIndex = CURR_CHUNK_INDEX;
+    // Fetch next element, jumps to end when exhausted
+    uint32_t jumpEndChunkIndex = writeJump(currentChunk, OP_ITER_NEXT, forToken->line, forToken->index, forToken->sourceIndex);
+    writeChunk16(currentChunk, iteratorSlot);
+    // Assign element to loop variable
+    uint16_t varIndex = getRefIndex(currentLocalRefTable, TOKEN_VALUE(varToken));
+    WRITEOP_CURRENT_CHUNK(OP_SET_LOCAL_REF_ATTR, varToken->line, varToken->index, varToken->sourceIndex);
+    writeChunk16(currentChunk, varIndex);
+    writeChunk8(currentChunk, ASSIGNMENT_NONE);
+    addChunkSetIndex(varIndex);
+
+    // Store previous jump list pointers
+    uint32_t* prevContinueJumpList = continueJumpList;
+    uint32_t* prevBreakJumpList = breakJumpList;
+    uint8_t prevContinueJumpIndex = continueJumpIndex;
+    uint8_t prevBreakJumpIndex = breakJumpIndex;
+
+    // Create new jump list pointers
+    continueJumpList = malloc(sizeof(uint32_t) * CONTINUE_JUMP_LIST_INIT_SIZE);
+    breakJumpList = malloc(sizeof(uint32_t) * BREAK_JUMP_LIST_INIT_SIZE);
+    continueJumpIndex = 0;
+    breakJumpIndex = 0;
+
+    // Parse for-each body, nested loops use their own iterator slots
+    forEachDepth++;
+    while (TOKEN_TYPE(currentToken) != RIGHT_BRACE) statement();
+    forEachDepth--;
+
+    // Add jump back instruction
+    writeJumpBack(currentChunk, OP_JUMP, loopStartChunkIndex, currentToken->line, currentToken->index, currentToken->sourceIndex);
+    incCheckNull();
+
+    // Patch break & continue jumps
+    patchBreakJumpsAtCurrent();
+    patchContinueJumps(loopStartChunkIndex);
+
+    // Free current jump list pointers
+    free(continueJumpList);
+    free(breakJumpList);
+
+    // Replace previous jump list pointers
+    continueJumpList = prevContinueJumpList;
+    breakJumpList = prevBreakJumpList;
+    continueJumpIndex = prevContinueJumpIndex;
+    breakJumpIndex = prevBreakJumpIndex;
+
+    // Patch jump
+    patchJumpAtCurrent(currentChunk, jumpEndChunkIndex);
+}
+
 void forStatement() {
     token* forToken = currentToken;
     // Check formatting
     incCheckType(LEFT_PARENTHESES, "Expected '(' after 'for'");
     incCheckNull();
+    // Check for for-each loop
+    if (TOKEN_TYPE(currentToken) == IDENTIFIER && currentToken->nextToken != NULL && TOKEN_TYPE(currentToken->nextToken) == KEYWORD_IN) {
+        forEachStatement(forToken);
+        return;
+    }
     // Pre-loop statement
     standardStatement();
     // Check formatting
     checkType(SEMICOLON, "Expected ';' after pre-loop statement");
     incCheckNull();
     // Note expression start location
-    uint16_t expressionStartChunkIndex = CURR_CHUNK_INDEX;
+    uint32_t expressionStartChunkIndex = CURR_CHUNK_INDEX;
     // Parse condition
     expression(true);
     // Check formatting
     checkType(SEMICOLON, "Expected ';' after condition");
     incCheckNull();
     // Add jump if false instruction
-    uint16_t jumpEndChunkIndex = writeJump(currentChunk, OP_JUMP_IF_FALSE, forToken->line, forToken->index, forToken->sourceIndex);
+    uint32_t jumpEndChunkIndex = writeJump(currentChunk, OP_JUMP_IF_FALSE, forToken->line, forToken->index, forToken->sourceIndex);
     // Store post-loop statement start chunk index
-    uint16_t postLoopChunkIndex = CURR_CHUNK_INDEX;
+    uint32_t postLoopChunkIndex = CURR_CHUNK_INDEX;
     // Parse post-loop statement
     standardStatement();
     // Check formatting
@@ -1169,14 +1441,14 @@ void forStatement() {
     Chunk* postLoopChunk = cropChunk(currentChunk, postLoopChunkIndex);
 
     // Store previous jump list pointers
-    uint16_t* prevContinueJumpList = continueJumpList;
-    uint16_t* prevBreakJumpList = breakJumpList;
+    uint32_t* prevContinueJumpList = continueJumpList;
+    uint32_t* prevBreakJumpList = breakJumpList;
     uint8_t prevContinueJumpIndex = continueJumpIndex;
     uint8_t prevBreakJumpIndex = breakJumpIndex;
 
     // Create new jump list pointers
-    continueJumpList = malloc(sizeof(uint16_t) * CONTINUE_JUMP_LIST_INIT_SIZE);
-    breakJumpList = malloc(sizeof(uint16_t) * BREAK_JUMP_LIST_INIT_SIZE);
+    continueJumpList = malloc(sizeof(uint32_t) * CONTINUE_JUMP_LIST_INIT_SIZE);
+    breakJumpList = malloc(sizeof(uint32_t) * BREAK_JUMP_LIST_INIT_SIZE);
     continueJumpIndex = 0;
     breakJumpIndex = 0;
 
@@ -1303,18 +1575,19 @@ Value defMethod(bool isVoidReturn, bool isInit) {
     isVoidReturnChunk = isVoidReturn;
 
     // Add self reference
-    chunkSetIndexArray[chunkSetIndexArrayIndex++] = getRefIndex(currentLocalRefTable, "self");
+    addChunkSetIndex(getRefIndex(currentLocalRefTable, "self"));
 
     // Load arguments
     while (TOKEN_TYPE(currentToken) == IDENTIFIER) {
         // Create local reference
-        chunkSetIndexArray[chunkSetIndexArrayIndex++] = getRefIndex(currentLocalRefTable, TOKEN_VALUE(currentToken));
+        addChunkSetIndex(getRefIndex(currentLocalRefTable, TOKEN_VALUE(currentToken)));
         // Increment token
         incCheckNull();
         // Check for comma
         if (TOKEN_TYPE(currentToken) == COMMA) incCheckType(IDENTIFIER, "Expected identifier after ','");
         inCount++;
     }
+    chunkParamCount = chunkSetIndexArrayIndex;
     // Check for format
     checkType(RIGHT_PARENTHESES, "Expected ')' after method arguments");
     incCheckType(LEFT_BRACE, "Expected '{' after method arguments");
@@ -1383,6 +1656,12 @@ void defClass() {
         incCheckNull();
         hasParent = true;
     }
+    // Immutable key classes cache their hash after the first computation
+    bool immutableKey = false;
+    if (TOKEN_TYPE(currentToken) == KEYWORD_IMMUTABLE) {
+        immutableKey = true;
+        incCheckNull();
+    }
     // Check for opening brace
     if (TOKEN_TYPE(currentToken) != LEFT_BRACE) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "Expected '{' after class name");
     incCheckNull();
@@ -1394,6 +1673,7 @@ void defClass() {
 
     // Create class
     objClass* currClass = createClass(className, getRefIndex(globalClassRefTable,className), initMethod, pClassID, CHUNK_FUNC_INIT_TYPE);
+    currClass->immutableKey = immutableKey;
 
     while (TOKEN_TYPE(currentToken) == KEYWORD_VOID || TOKEN_TYPE(currentToken) == IDENTIFIER) {
         bool isVoidReturn = TOKEN_TYPE(currentToken) == KEYWORD_VOID;
@@ -1407,7 +1687,7 @@ void defClass() {
 
 #ifdef DEBUG_PRINT_PRIOR_TO_OPTIMIZATION
     printf("\nClass \"%s\" defined:\n", className);
-    printObjClass((Value) currClass);
+    printObjClass(currClass);
 #endif
 }
 
@@ -1433,7 +1713,7 @@ void defFunction(bool isVoidReturn) {
         if (TOKEN_TYPE(currentToken) == IDENTIFIER) {
             if (strcmp(TOKEN_VALUE(currentToken), "inArgs") != 0) compilationError(currentToken->line, currentToken->index, currentToken->sourceIndex, "main function can only have one argument: \"inArgs\" or no arguments");
             // Create local reference
-            chunkSetIndexArray[chunkSetIndexArrayIndex++] = getRefIndex(currentLocalRefTable, TOKEN_VALUE(currentToken));
+            addChunkSetIndex(getRefIndex(currentLocalRefTable, TOKEN_VALUE(currentToken)));
             // Increment token
             incCheckNull();
             inCount++;
@@ -1444,7 +1724,7 @@ void defFunction(bool isVoidReturn) {
             // Here for each of the arguments, we create a local reference, frame will be shifted by the appropriate amount
             // therefore popping and pushing will not be necessary
             // Create local reference
-            chunkSetIndexArray[chunkSetIndexArrayIndex++] = getRefIndex(currentLocalRefTable, TOKEN_VALUE(currentToken));
+            addChunkSetIndex(getRefIndex(currentLocalRefTable, TOKEN_VALUE(currentToken)));
             // Increment token
             incCheckNull();
             // Check for comma
@@ -1452,6 +1732,7 @@ void defFunction(bool isVoidReturn) {
             inCount++;
         }
     }
+    chunkParamCount = chunkSetIndexArrayIndex;
     // Check for format
     checkType(RIGHT_PARENTHESES, "Expected ')' after function arguments");
     incCheckType(LEFT_BRACE, "Expected '{' after function arguments");
@@ -1511,7 +1792,7 @@ callable** checkPrelinkedCall() {
         if (VALUE_TYPE(targetFunc) != BUILTIN_CALLABLE) compilationError(callToken->line, callToken->index, callToken->sourceIndex, "Object is not callable");
         if (VALUE_CALLABLE_VALUE(targetFunc)->in != -1 && VALUE_CALLABLE_VALUE(targetFunc)->in != GET_BYTE(command, 1)) compilationError(callToken->line, callToken->index, callToken->sourceIndex, "Incorrect number of arguments");
         // Check if already written in function array
-        uint16_t functionIndex = GET_WORD(command, 2);
+        uint32_t functionIndex = GET_DWORD(command, 2);
         if (functionArray[functionIndex] == NULL) functionArray[functionIndex] = VALUE_CALLABLE_VALUE(targetFunc);
         // Free node
         preLinkedCallNode* nextNode = currNode->next;
@@ -1522,6 +1803,7 @@ callable** checkPrelinkedCall() {
 }
 
 void checkClassInheritance() {
+    if (globalClassRefTable->numEntries > MAX_CLASS_NUM) compilationError(0, 0, 0, "Class count exceeds maximum");
     for (uint32_t i=0; i<globalClassRefTable->numEntries; i++) {
         // Check if all classes with parent class have a non-null parentClass pointer
         if (classArray[i]->pClassID != 0 && classArray[i]->parentClass == NULL) {
@@ -1533,6 +1815,15 @@ void checkClassInheritance() {
             }
         }
     }
+    // Reject cyclic inheritance, flattened attribute tables are built by walking parents
+    for (uint32_t i=0; i<globalClassRefTable->numEntries; i++) {
+        objClass* currClass = classArray[i];
+        uint32_t depth = 0;
+        while (currClass != NULL) {
+            if (depth++ > globalClassRefTable->numEntries) compilationError(0, 0, 0, "Cyclic class inheritance");
+            currClass = currClass->parentClass;
+        }
+    }
 }
 
 Value* compactGlobalRefTable() {
@@ -1546,7 +1837,7 @@ Value* compactGlobalRefTable() {
         for (uint32_t j=0; j<currChunk->count; j++) {
             OpCode op = (uint8_t)(*currLine & 0xFF);
             if (op == OP_GET_GLOBAL_REF_ATTR || op == OP_SET_GLOBAL_REF_ATTR) {
-                uint16_t globalRefIndex = (uint16_t)((*currLine >> (1 * 8)) & 0xFFFF);
+                uint32_t globalRefIndex = GET_DWORD(*currLine, 1);
                 grMap[globalRefIndex] = 1;
             }
             // Increment line
@@ -1569,7 +1860,7 @@ Value* compactGlobalRefTable() {
         for (uint32_t j=0; j<currChunk->count; j++) {
             OpCode op = (uint8_t)(*currLine & 0xFF);
             if (op == OP_GET_COMBINED_REF_ATTR || op == OP_SET_COMBINED_REF_ATTR) {
-                uint16_t globalRefIndex = (uint16_t)((*currLine >> (3 * 8)) & 0xFFFF);
+                uint32_t globalRefIndex = GET_DWORD(*currLine, 3);
                 // Determine if global ref is in compacted global ref table
                 if (grMap[globalRefIndex] == -1) {
                     // Change to get local
@@ -1578,25 +1869,25 @@ Value* compactGlobalRefTable() {
                     } else {
                         *currLine = SET_BOTTOM_8_BITS(*currLine, OP_SET_LOCAL_REF_ATTR);
                         // Get special assignment
-                        specialAssignment sa = GET_BYTE(*currLine, 5);
-                        // Clear byte after initial 24 bite
-                        *currLine &= ~(0xFFULL << 24);
+                        specialAssignment sa = GET_BYTE(*currLine, 7);
+                        // Clear operands after initial 24 bits
+                        *currLine &= 0xFFFFFFULL;
                         // Write to line after initial 24 bits
                         *currLine |= ((uint64_t)sa << 24);
                     }
                 } else {
                     // Change to new index
-                    // Clear the next 16 bite after initial 24 bits
-                    *currLine &= ~(0xFFFFULL << 24);
-                    // Set the next 16 bits to the new mapped index
+                    // Clear the next 32 bits after initial 24 bits
+                    *currLine &= ~(0xFFFFFFFFULL << 24);
+                    // Set the next 32 bits to the new mapped index
                     *currLine |= ((uint64_t)grMap[globalRefIndex] << 24);
                 }
             } else if (op == OP_GET_GLOBAL_REF_ATTR || op == OP_SET_GLOBAL_REF_ATTR) {
                 // Change to new index
-                uint16_t globalRefIndex = (uint16_t)((*currLine >> (1 * 8)) & 0xFFFF);
-                // Clear the next 16 bits after the 8-bit opcode
-                *currLine &= ~(0xFFFFULL << 8);
-                // Set the next 16 bits to the new mapped index
+                uint32_t globalRefIndex = GET_DWORD(*currLine, 1);
+                // Clear the next 32 bits after the 8-bit opcode
+                *currLine &= ~(0xFFFFFFFFULL << 8);
+                // Set the next 32 bits to the new mapped index
                 *currLine |= ((uint64_t)grMap[globalRefIndex] << 8);
             }
             // Increment line
@@ -1718,6 +2009,8 @@ Value compile(refTable* GRTable, refTable* globalClassTable, runtimeList* GRList
 
     // Set total amount of class
     setTotalClassCount(globalClassTable->numEntries);
+    // Flatten inherited class attributes
+    resolveAllClassAttrs();
 
     // Compact global reference
     GAsize = globalArraySize;
@@ -1736,6 +2029,8 @@ Value compile(refTable* GRTable, refTable* globalClassTable, runtimeList* GRList
     freeRefTable(prelinkedFuncTable);
     freeRefTable(globalDeclTable);
     freeRuntimeDict(compilerConstantHash);
+    free(chunkSetIndexArray);
+    chunkSetIndexArray = NULL;
     freeTokenizer();
 
     if (!mainFound) compilationError(0, 0, 0, "No main function found");
@@ -76,6 +76,7 @@ void returnStatement();
 void ifStatement();
 void whileStatement();
 void forStatement();
+void forEachStatement(token* forToken);
 
 // Declaration parsing
 void defClass();
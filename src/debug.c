@@ -6,6 +6,7 @@
 #include "errors.h"
 #include "runtimeDS.h"
 #include "compiler.h"
+#include "symbolTable.h"
 
 #define GET_NIBBLE(data, shift) ((uint8_t)(((data) >> ((shift) * 4)) & 0xF))
 #define GET_BYTE(data, shift)  ((uint8_t) (((data) >> ((shift) * 8)) & 0xFF))
@@ -48,8 +49,13 @@ void printConstOpWithPayload(char* name, Chunk* c, uint64_t line) {
 void printSingleOp(char* name, Chunk* c, uint64_t line) {
     printf("%s\n", name);
     printf("    Var1 -> ");
-    DSPrintValue(c->constants->data[GET_BYTE(line, 1)]);
-    printf(" (constant #%u)", GET_BYTE(line, 1));
+    DSPrintValue(c->constants->data[GET_DWORD(line, 1)]);
+    printf(" (constant #%u)", GET_DWORD(line, 1));
+}
+
+void printSymbolOp(char* name, Chunk* c, uint64_t line) {
+    printf("%s\n", name);
+    printf("    Symbol -> \"%s\" (symbol #%u)", getSymbolName(GET_DWORD(line, 1)), GET_DWORD(line, 1));
 }
 
 void printSingleNewOp(char* name, Chunk* c, uint64_t line) {
@@ -63,12 +69,18 @@ void printSingleRefArrayOp(char* name, Chunk* c, uint64_t line) {
     printf("%u", GET_WORD(line, 1));
 }
 
+void printGlobalRefArrayOp(char* name, Chunk* c, uint64_t line) {
+    printf("%s\n", name);
+    printf("    RefArrayIndex -> ");
+    printf("%u", GET_DWORD(line, 1));
+}
+
 void printDoubleRefArrayOp(char* name, Chunk* c, uint64_t line) {
     printf("%s\n", name);
     printf("    LocalRefArrayIndex -> ");
     printf("%u", GET_WORD(line, 1));
     printf("\n    GlobalRefArrayIndex -> ");
-    printf("%u", GET_WORD(line, 3));
+    printf("%u", GET_DWORD(line, 3));
 }
 
 void printExecOp(char* name, Chunk* c, uint64_t line) {
@@ -77,12 +89,21 @@ void printExecOp(char* name, Chunk* c, uint64_t line) {
     printf("%u", GET_BYTE(line, 1));
 }
 
+void printIntrinsicOp(char* name, Chunk* c, uint64_t line) {
+    printf("%s\n", name);
+    printf("    Symbol -> \"%s\" (symbol #%u)", getSymbolName(GET_DWORD(line, 1)), GET_DWORD(line, 1));
+    printf("\n    NumAttr -> ");
+    printf("%u", GET_BYTE(line, 5));
+    printf("\n    Intrinsic -> ");
+    printf("%u", GET_BYTE(line, 6));
+}
+
 void printPrelinkedExecOp(char* name, Chunk* c, uint64_t line) {
     printf("%s\n", name);
     printf("    NumAttr -> ");
     printf("%u", GET_BYTE(line, 1));
     printf("\n    PrelinkedIndex -> ");
-    printf("%u", GET_WORD(line, 2));
+    printf("%u", GET_DWORD(line, 2));
 }
 
 void printSpecialAssign(specialAssignment sa) {
@@ -120,13 +141,11 @@ void printConstOpSpecialAssign(char* name, Chunk* c, uint64_t line) {
     printSpecialAssign(GET_BYTE(line, 1));
 }
 
-void printSingleOpSpecialAssign(char* name, Chunk* c, uint64_t line) {
+void printSymbolOpSpecialAssign(char* name, Chunk* c, uint64_t line) {
     printf("%s\n", name);
-    printf("    Var1 -> ");
-    DSPrintValue(c->constants->data[GET_BYTE(line, 1)]);
-    printf(" (constant #%u)", GET_BYTE(line, 1));
+    printf("    Symbol -> \"%s\" (symbol #%u)", getSymbolName(GET_DWORD(line, 1)), GET_DWORD(line, 1));
     printf("\n    Var2 -> ");
-    printSpecialAssign(GET_BYTE(line, 2));
+    printSpecialAssign(GET_BYTE(line, 5));
 }
 
 void printSingleRefArraySpecialAssign(char* name, Chunk* c, uint64_t line) {
@@ -137,33 +156,53 @@ void printSingleRefArraySpecialAssign(char* name, Chunk* c, uint64_t line) {
     printSpecialAssign(GET_BYTE(line, 3));
 }
 
+void printGlobalRefArraySpecialAssign(char* name, Chunk* c, uint64_t line) {
+    printf("%s\n", name);
+    printf("    RefArrayIndex -> ");
+    printf("%u", GET_DWORD(line, 1));
+    printf("\n    Var2 -> ");
+    printSpecialAssign(GET_BYTE(line, 5));
+}
+
 void printDoubleRefArraySpecialAssign(char* name, Chunk* c, uint64_t line) {
     printf("%s\n", name);
     printf("    LocalRefArrayIndex -> ");
     printf("%u", GET_WORD(line, 1));
     printf("\n    GlobalRefArrayIndex -> ");
-    printf("%u", GET_WORD(line, 3));
+    printf("%u", GET_DWORD(line, 3));
     printf("\n    Var3 -> ");
-    printSpecialAssign(GET_BYTE(line, 5));
+    printSpecialAssign(GET_BYTE(line, 7));
 }
 
 void printJumpOp(char* name, Chunk* c, uint64_t line) {
     printf("%s\n", name);
-    int16_t jumpInc = GET_WORD(line, 1);
+    int32_t jumpInc = GET_DWORD(line, 1);
     printf("    Line Inc[%d]", jumpInc);
 }
 
+void printIterInit(uint64_t line) {
+    printf("OP_ITER_INIT\n");
+    printf("    IteratorRefArrayIndex -> %u", GET_WORD(line, 1));
+}
+
+void printIterNext(uint64_t line) {
+    printf("OP_ITER_NEXT\n");
+    int32_t jumpInc = GET_DWORD(line, 1);
+    printf("    Line Inc[%d]\n", jumpInc);
+    printf("    IteratorRefArrayIndex -> %u", GET_WORD(line, 5));
+}
+
 void printSetHandler(uint64_t line) {
     printf("OP_SET_HANDLER\n");
     printf("    Handler Batch Count -> %u\n", GET_BYTE(line, 1));
-    printf("    To Line [%d]", GET_WORD(line, 2));
-    printf("\n    Payload -> %u", GET_WORD(line, 4));
+    printf("    To Line [%u]", GET_DWORD(line, 2));
+    printf("\n    Payload -> %u", GET_WORD(line, 6));
 }
 
 void printSetAllHanler(uint64_t line) {
     printf("OP_SET_ALL_HANDLER\n");
     printf("    Handler Batch Count -> %u\n", GET_BYTE(line, 1));
-    printf("    To Line [%d]", GET_WORD(line, 2));
+    printf("    To Line [%u]", GET_DWORD(line, 2));
 }
 
 void printPopHandler(uint64_t line) {
@@ -200,16 +239,16 @@ void printInstr(uint64_t line, Chunk* c) {
         case OP_IS: printConstOp("OP_IS", c, line); break;
         case OP_GET_SELF: printConstOp("OP_GET_SELF", c, line); break;
         case OP_GET_INDEX_REF: printConstOp("OP_GET_INDEX_REF", c, line); break;
-        case OP_GET_GLOBAL_REF_ATTR: printSingleRefArrayOp("OP_GET_GLOBAL_REF_ATTR", c, line); break;
+        case OP_GET_GLOBAL_REF_ATTR: printGlobalRefArrayOp("OP_GET_GLOBAL_REF_ATTR", c, line); break;
         case OP_GET_LOCAL_REF_ATTR: printSingleRefArrayOp("OP_GET_LOCAL_REF_ATTR", c, line); break;
         case OP_GET_COMBINED_REF_ATTR: printDoubleRefArrayOp("OP_GET_COMBINED_REF_ATTR", c, line); break;
-        case OP_GET_ATTR: printSingleOp("OP_GET_ATTR", c, line); break;
-        case OP_GET_ATTR_CALL: printSingleOp("OP_GET_ATTR_CALL", c, line); break;
+        case OP_GET_ATTR: printSymbolOp("OP_GET_ATTR", c, line); break;
+        case OP_GET_ATTR_CALL: printSymbolOp("OP_GET_ATTR_CALL", c, line); break;
         case OP_SET_INDEX_REF: printConstOpSpecialAssign("OP_SET_INDEX_REF", c, line); break;
-        case OP_SET_GLOBAL_REF_ATTR: printSingleRefArraySpecialAssign("OP_SET_GLOBAL_REF_ATTR", c, line); break;
+        case OP_SET_GLOBAL_REF_ATTR: printGlobalRefArraySpecialAssign("OP_SET_GLOBAL_REF_ATTR", c, line); break;
         case OP_SET_LOCAL_REF_ATTR: printSingleRefArraySpecialAssign("OP_SET_LOCAL_REF_ATTR", c, line); break;
         case OP_SET_COMBINED_REF_ATTR: printDoubleRefArraySpecialAssign("OP_SET_COMBINED_REF_ATTR", c, line); break;
-        case OP_SET_ATTR: printSingleOpSpecialAssign("OP_SET_ATTR", c, line); break;
+        case OP_SET_ATTR: printSymbolOpSpecialAssign("OP_SET_ATTR", c, line); break;
         case OP_SET_HANDLER: printSetHandler(line); break;
         case OP_SET_ALL_HANDLER: printSetAllHanler(line); break;
         case OP_POP_HANDLER: printPopHandler(line); break;
@@ -218,12 +257,16 @@ void printInstr(uint64_t line, Chunk* c) {
         case OP_EXEC_FUNCTION_IGNORE_RETURN: printPrelinkedExecOp("OP_EXEC_FUNCTION_IGNORE_RETURN", c, line); break;
         case OP_EXEC_METHOD_ENFORCE_RETURN: printExecOp("OP_EXEC_METHOD_ENFORCE_RETURN", c, line); break;
         case OP_EXEC_METHOD_IGNORE_RETURN: printExecOp("OP_EXEC_METHOD_IGNORE_RETURN", c, line); break;
+        case OP_INVOKE_INTRINSIC_ENFORCE_RETURN: printIntrinsicOp("OP_INVOKE_INTRINSIC_ENFORCE_RETURN", c, line); break;
+        case OP_INVOKE_INTRINSIC_IGNORE_RETURN: printIntrinsicOp("OP_INVOKE_INTRINSIC_IGNORE_RETURN", c, line); break;
         case OP_INIT: printSingleNewOp("OP_INIT", c, line); break;
         case OP_GET_PARENT_INIT: printConstOp("OP_GET_PARENT_INIT", c, line); break;
         case OP_RETURN: printConstOp("OP_RETURN", c, line); break;
         case OP_RETURN_NONE: printConstOp("OP_RETURN_NONE", c, line); break;
         case OP_JUMP: printJumpOp("OP_JUMP", c, line); break;
         case OP_JUMP_IF_FALSE: printJumpOp("OP_JUMP_IF_FALSE", c, line); break;
+        case OP_ITER_INIT: printIterInit(line); break;
+        case OP_ITER_NEXT: printIterNext(line); break;
         default:
             raiseExceptionByName("DisassemblerError", "Disassembler: Unknown opcode\n");
     }
@@ -337,6 +380,8 @@ void printToken(token* t) {
         case KEYWORD_HANDLE: printf("KEYWORD_HANDLE"); break;
         case KEYWORD_TRY: printf("KEYWORD_TRY"); break;
         case KEYWORD_RAISE: printf("KEYWORD_RAISE"); break;
+        case KEYWORD_IN: printf("KEYWORD_IN"); break;
+        case KEYWORD_IMMUTABLE: printf("KEYWORD_IMMUTABLE"); break;
 
         // Identifiers
         case IDENTIFIER: printf("IDENTIFIER"); break;
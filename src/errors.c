@@ -22,6 +22,10 @@ Chunk** cArray = NULL;
 uint32_t chunkArraySize = 0;
 
 void attachSource(char* s, char* sourceName) {
+    if (sourceCount >= MAX_SOURCE_SIZE) {
+        fprintf(stderr, "\nattachSourceError: Source count exceeds %d\n", MAX_SOURCE_SIZE);
+        exit(EXIT_FAILURE);
+    }
     sourceArray[sourceCount] = s;
     fileNameArray[sourceCount] = addReference(sourceName);
     sourceCount++;
@@ -65,10 +69,10 @@ void printFrame(uint64_t* ip) {
     for (uint32_t i=0; i<chunkArraySize; i++) {
         if (ip >= cArray[i]->code && ip < cArray[i]->code + cArray[i]->count) {
             uint32_t offset = ip - cArray[i]->code;
-            uint16_t line = cArray[i]->lines[offset];
+            uint32_t line = cArray[i]->lines[offset];
 
-            uint8_t index = cArray[i]->indices[offset];
-            uint8_t sourceIndex = cArray[i]->sourceIndices[offset];
+            uint16_t index = cArray[i]->indices[offset];
+            uint16_t sourceIndex = cArray[i]->sourceIndices[offset];
 #ifdef PRINT_ERROR_OP
             printf("Current instruction: \n");
             printInstr(*ip, cArray[i]);
@@ -138,6 +142,7 @@ void addBuiltinExceptions(refTable* exceptionRefTable) {
     addException("DictError", true);
     addException("ListError", true);
     addException("SetError", true);
+    addException("ArrayError", true);
     addException("GCError", true);
     addException("InternalError", true);
     addException("ReturnCountError", true);
@@ -214,13 +219,13 @@ void raiseExceptionByName(char* name, char* message) {
 }
 
 // Pre-runtime errors
-void parsingError(uint16_t line, uint8_t index, uint8_t sourceIndex, char *message) {
+void parsingError(uint32_t line, uint16_t index, uint16_t sourceIndex, char *message) {
     fprintf(stderr, "\nparsingError: %s\n", message);
     printSourceLocation(line, index, sourceIndex);
     exit(EXIT_FAILURE);
 }
 
-void compilationError(uint16_t line, uint8_t index, uint8_t sourceIndex, char *message) {
+void compilationError(uint32_t line, uint16_t index, uint16_t sourceIndex, char *message) {
     fprintf(stderr, "\ncompilationError: %s\n", message);
     printSourceLocation(line, index, sourceIndex);
     exit(EXIT_FAILURE);
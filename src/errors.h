@@ -36,9 +36,9 @@ void raiseExceptionById(uint32_t id, char* message);
 
 void raiseExceptionByName(char* name, char* message);
 
-void parsingError(uint16_t line, uint8_t index, uint8_t sourceIndex, char *message);
+void parsingError(uint32_t line, uint16_t index, uint16_t sourceIndex, char *message);
 
-void compilationError(uint16_t line, uint8_t index, uint8_t sourceIndex, char *message);
+void compilationError(uint32_t line, uint16_t index, uint16_t sourceIndex, char *message);
 
 void freeErrorTracer();
 
@@ -4,10 +4,12 @@
 #include <string.h>
 
 #include "stringHash.h"
+#include "symbolTable.h"
 #include "object.h"
 #include "common.h"
 #include "vm.h"
 #include "builtinClasses.h"
+#include "slabAllocator.h"
 #include "runtimeDS.h"
 #include "compiler.h"
 #include "errors.h"
@@ -19,14 +21,17 @@
 
 void initAllTables() {
     initStringHash();
+    initSymbolTable();
     initObjectManager();
 }
 
 void deleteAllTables() {
     freeVM();
     freeObjectManager();
+    freeSymbolTable();
     deleteStringHash();
     freeErrorTracer();
+    freeSlabAllocator();
 }
 
 int main(int argc, const char* argv[]) {
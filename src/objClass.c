@@ -4,6 +4,7 @@
 
 #include "objClass.h"
 #include "stringHash.h"
+#include "objShape.h"
 #include "errors.h"
 #include "common.h"
 
@@ -12,6 +13,7 @@ uint32_t classCount = 0;
 objClass** classArray;
 
 objClass* createClass(char* name, uint32_t classID, Value initFunc, uint32_t pClassID, initFuncType initType) {
+    if (classID >= MAX_CLASS_NUM) raiseExceptionByName("ObjHashError", "Class count exceeds maximum");
     // Create class
     objClass* newClass = malloc(sizeof(objClass));
     classArray[classID] = newClass;
@@ -23,8 +25,12 @@ objClass* createClass(char* name, uint32_t classID, Value initFunc, uint32_t pCl
     // Temporarily set this to null, as it will be checked later
     newClass->parentClass = NULL;
     newClass->initFunc = initFunc;
-    newClass->predefinedAttrs = createStrValHashTable(CLASS_ATTR_TABLE_INIT_SIZE);
+    newClass->predefinedAttrs = createSymValTable(CLASS_ATTR_TABLE_INIT_SIZE);
+    newClass->resolvedAttrs = NULL;
     newClass->initType = initType;
+    newClass->rootShape = IS_SYSTEM_DEFINED_CLASS(newClass) ? NULL : createRootShape();
+    newClass->expectedSlotCount = 0;
+    newClass->immutableKey = false;
 
     return newClass;
 }
@@ -47,7 +53,9 @@ void setTotalClassCount(uint32_t count) {
 
 void deleteClass(objClass* c) {
     removeReference(c->className);
-    deleteStrValHashTable(c->predefinedAttrs);
+    deleteSymValTable(c->predefinedAttrs);
+    if (c->resolvedAttrs != NULL) deleteSymValTable(c->resolvedAttrs);
+    if (c->rootShape != NULL) freeShapeTree(c->rootShape);
     free(c);
 }
 
@@ -57,3 +65,56 @@ void freeClassArray() {
     classCount = 0;
 }
 
+
+void classAddAttr(objClass* c, char* attrName, Value attrValue) {
+    symValInsert(c->predefinedAttrs, internSymbol(attrName), attrValue);
+    invalidateResolvedAttrs(c);
+}
+
+symValueTable* resolveClassAttrs(objClass* c) {
+    if (c->resolvedAttrs != NULL) return c->resolvedAttrs;
+    symValueTable* table = createSymValTable(CLASS_ATTR_TABLE_INIT_SIZE);
+    // Inherited entries first so that own attributes override them
+    if (c->parentClass != NULL) {
+        symValueTable* parentAttrs = resolveClassAttrs(c->parentClass);
+        for (uint32_t i = 0; i < parentAttrs->tableSize; i++) {
+            symValueEntry* entry = &parentAttrs->entries[i];
+            if (entry->symbol != SYMBOL_NONE) symValInsert(table, entry->symbol, entry->value);
+        }
+    }
+    symValueTable* ownAttrs = c->predefinedAttrs;
+    for (uint32_t i = 0; i < ownAttrs->tableSize; i++) {
+        symValueEntry* entry = &ownAttrs->entries[i];
+        if (entry->symbol != SYMBOL_NONE) symValInsert(table, entry->symbol, entry->value);
+    }
+    c->resolvedAttrs = table;
+    // Cache operator methods for direct dispatch
+    for (uint32_t i = 0; i < OPERATOR_SYMBOL_COUNT; i++) c->operatorSlots[i] = symValFind(table, FIRST_OPERATOR_SYMBOL + i);
+    return table;
+}
+
+void resolveAllClassAttrs() {
+    for (uint32_t i = 0; i < classCount; i++) resolveClassAttrs(classArray[i]);
+}
+
+static inline bool isSubclassOf(objClass* c, objClass* ancestor) {
+    while (c != NULL) {
+        if (c == ancestor) return true;
+        c = c->parentClass;
+    }
+    return false;
+}
+
+void invalidateResolvedAttrs(objClass* c) {
+    if (c->resolvedAttrs != NULL) {
+        deleteSymValTable(c->resolvedAttrs);
+        c->resolvedAttrs = NULL;
+    }
+    // Subclasses copied the old entries, drop theirs as well
+    for (uint32_t i = 0; i < classCount; i++) {
+        objClass* currClass = classArray[i];
+        if (currClass == NULL || currClass->resolvedAttrs == NULL || !isSubclassOf(currClass, c)) continue;
+        deleteSymValTable(currClass->resolvedAttrs);
+        currClass->resolvedAttrs = NULL;
+    }
+}
@@ -7,7 +7,13 @@
 
 #include "object.h"
 
-void printObjClass(Object* c);
+#define CLASS_ADD_ATTR(c, attrName, attrValue) classAddAttr(c, attrName, attrValue)
+// Looks up own and inherited attributes, resolving the flattened table on demand
+#define CLASS_RESOLVED_ATTRS(c) ((c)->resolvedAttrs != NULL ? (c)->resolvedAttrs : resolveClassAttrs(c))
+#define CLASS_FIND_ATTR(c, symbol) symValFind(CLASS_RESOLVED_ATTRS(c), symbol)
+#define CLASS_FIND_OPERATOR(c, symbol) (CLASS_RESOLVED_ATTRS(c), (c)->operatorSlots[(symbol) - FIRST_OPERATOR_SYMBOL])
+
+void printObjClass(objClass* oc);
 
 // Class functions
 
@@ -17,5 +23,10 @@ void initClassArray();
 void setTotalClassCount(uint32_t count);
 void freeClassArray();
 
+void classAddAttr(objClass* c, char* attrName, Value attrValue);
+symValueTable* resolveClassAttrs(objClass* c);
+void resolveAllClassAttrs();
+void invalidateResolvedAttrs(objClass* c);
+
 
 #endif //CJ_2_OBJCLASS_H
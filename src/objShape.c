@@ -0,0 +1,156 @@
+//
+// Created by congyu on 10/19/26.
+//
+
+#include "objShape.h"
+#include "errors.h"
+#include "common.h"
+#include "runtimeMemoryManager.h"
+#include "slabAllocator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static objShape* createShape(objShape* parent, uint32_t attrSymbol) {
+    objShape* shape = malloc(sizeof(objShape));
+    if (shape == NULL) raiseExceptionByName("ObjHashError", "Memory allocation for shape failed");
+    shape->parent = parent;
+    shape->transitions = NULL;
+    shape->transitionCount = 0;
+    shape->transitionCapacity = 0;
+    shape->attrSymbol = attrSymbol;
+    if (parent == NULL) {
+        shape->hasOperatorAttrs = false;
+        shape->slotCount = 0;
+        shape->slotSymbols = NULL;
+        return shape;
+    }
+    shape->hasOperatorAttrs = parent->hasOperatorAttrs || IS_OPERATOR_SYMBOL(attrSymbol);
+    shape->slotCount = parent->slotCount + 1;
+    shape->slotSymbols = malloc(sizeof(uint32_t) * shape->slotCount);
+    if (shape->slotSymbols == NULL) raiseExceptionByName("ObjHashError", "Memory allocation for shape slots failed");
+    if (parent->slotCount > 0) memcpy(shape->slotSymbols, parent->slotSymbols, sizeof(uint32_t) * parent->slotCount);
+    shape->slotSymbols[parent->slotCount] = attrSymbol;
+    return shape;
+}
+
+objShape* createRootShape() {
+    return createShape(NULL, SYMBOL_NONE);
+}
+
+void freeShapeTree(objShape* shape) {
+    for (uint32_t i = 0; i < shape->transitionCount; i++) freeShapeTree(shape->transitions[i]);
+    if (shape->transitions != NULL) free(shape->transitions);
+    if (shape->slotSymbols != NULL) free(shape->slotSymbols);
+    free(shape);
+}
+
+int32_t shapeFindSlot(objShape* shape, uint32_t symbol) {
+    uint32_t* slotSymbols = shape->slotSymbols;
+    for (uint32_t i = 0; i < shape->slotCount; i++) {
+        if (slotSymbols[i] == symbol) return (int32_t) i;
+    }
+    return -1;
+}
+
+// Returns NULL once the shape tree should not grow any further
+static objShape* shapeTransition(objShape* shape, uint32_t symbol) {
+    for (uint32_t i = 0; i < shape->transitionCount; i++) {
+        if (shape->transitions[i]->attrSymbol == symbol) return shape->transitions[i];
+    }
+    if (shape->slotCount >= SHAPE_MAX_SLOT_COUNT || shape->transitionCount >= SHAPE_MAX_TRANSITION_COUNT) return NULL;
+    if (shape->transitionCount == shape->transitionCapacity) {
+        uint32_t newCapacity = shape->transitionCapacity == 0 ? SHAPE_TRANSITION_INIT_SIZE : shape->transitionCapacity * 2;
+        objShape** newTransitions = realloc(shape->transitions, sizeof(objShape*) * newCapacity);
+        if (newTransitions == NULL) raiseExceptionByName("ObjHashError", "Memory allocation for shape transitions failed");
+        shape->transitions = newTransitions;
+        shape->transitionCapacity = newCapacity;
+    }
+    objShape* child = createShape(shape, symbol);
+    shape->transitions[shape->transitionCount++] = child;
+    return child;
+}
+
+void printShapeTree(objShape* shape, uint32_t depth) {
+    for (uint32_t i = 0; i < depth; i++) printf("    ");
+    printf("Shape: [slotCount: %u, attr: \"%s\", transitions: %u]\n", shape->slotCount,
+           shape->attrSymbol == SYMBOL_NONE ? "" : getSymbolName(shape->attrSymbol), shape->transitionCount);
+    for (uint32_t i = 0; i < shape->transitionCount; i++) printShapeTree(shape->transitions[i], depth + 1);
+}
+
+objAttrs* createObjAttrs(objClass* c) {
+    // Presize to the largest shape seen so far, most objects never grow
+    uint32_t capacity = c->expectedSlotCount;
+    objAttrs* attrs = slabAlloc(sizeof(objAttrs) + sizeof(Value) * capacity);
+    if (attrs == NULL) raiseExceptionByName("ObjHashError", "Memory allocation for object attributes failed");
+    attrs->shape = c->rootShape;
+    attrs->dictAttrs = NULL;
+    attrs->capacity = capacity;
+    attrs->hasCachedHash = false;
+    return attrs;
+}
+
+void freeObjAttrs(objAttrs* attrs) {
+    if (attrs->dictAttrs != NULL) deleteSymValTable(attrs->dictAttrs);
+    slabFree(attrs, sizeof(objAttrs) + sizeof(Value) * attrs->capacity);
+}
+
+Value objAttrFind(objAttrs* attrs, uint32_t symbol) {
+    if (OBJ_ATTRS_IS_DICT_MODE(attrs)) return symValFind(attrs->dictAttrs, symbol);
+    int32_t slot = shapeFindSlot(attrs->shape, symbol);
+    if (slot < 0) return INTERNAL_NULL_VAL;
+    return attrs->slots[slot];
+}
+
+static objAttrs* switchToDictMode(Object* obj) {
+    objAttrs* attrs = obj->primValue.attrs;
+    objShape* shape = attrs->shape;
+    symValueTable* table = createSymValTable(OBJECT_ATTR_TABLE_INIT_SIZE);
+    for (uint32_t i = 0; i < shape->slotCount; i++) symValInsert(table, shape->slotSymbols[i], attrs->slots[i]);
+    // Release slot storage
+    objAttrs* newAttrs = slabRealloc(attrs, sizeof(objAttrs) + sizeof(Value) * attrs->capacity, sizeof(objAttrs));
+    if (newAttrs != NULL) {
+        attrs = newAttrs;
+        attrs->capacity = 0;
+    }
+    attrs->shape = NULL;
+    attrs->dictAttrs = table;
+    obj->primValue.attrs = attrs;
+    return attrs;
+}
+
+void objAttrSet(Object* obj, uint32_t symbol, Value value) {
+    GC_WRITE_BARRIER(obj, value);
+    objAttrs* attrs = obj->primValue.attrs;
+    if (OBJ_ATTRS_IS_DICT_MODE(attrs)) {
+        symValInsert(attrs->dictAttrs, symbol, value);
+        return;
+    }
+    // Existing attribute
+    int32_t slot = shapeFindSlot(attrs->shape, symbol);
+    if (slot >= 0) {
+        attrs->slots[slot] = value;
+        return;
+    }
+    // New attribute, follow or create a transition
+    objShape* nextShape = shapeTransition(attrs->shape, symbol);
+    if (nextShape == NULL) {
+        attrs = switchToDictMode(obj);
+        symValInsert(attrs->dictAttrs, symbol, value);
+        return;
+    }
+    if (nextShape->slotCount > attrs->capacity) {
+        uint32_t newCapacity = attrs->capacity < 4 ? 4 : attrs->capacity * 2;
+        if (newCapacity > SHAPE_MAX_SLOT_COUNT) newCapacity = SHAPE_MAX_SLOT_COUNT;
+        attrs = slabRealloc(attrs, sizeof(objAttrs) + sizeof(Value) * attrs->capacity, sizeof(objAttrs) + sizeof(Value) * newCapacity);
+        if (attrs == NULL) raiseExceptionByName("ObjHashError", "Memory allocation for object slots failed");
+        attrs->capacity = newCapacity;
+        obj->primValue.attrs = attrs;
+    }
+    attrs->slots[nextShape->slotCount - 1] = value;
+    attrs->shape = nextShape;
+    // Let later instances start with enough slots
+    objClass* c = classArray[obj->type];
+    if (nextShape->slotCount > c->expectedSlotCount) c->expectedSlotCount = nextShape->slotCount;
+}
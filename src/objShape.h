@@ -0,0 +1,26 @@
+//
+// Created by congyu on 10/19/26.
+//
+
+#ifndef CJ_2_OBJSHAPE_H
+#define CJ_2_OBJSHAPE_H
+
+#include "object.h"
+
+#define OBJ_ATTRS_IS_DICT_MODE(attrs) ((attrs)->shape == NULL)
+
+// Shape functions
+
+objShape* createRootShape();
+void freeShapeTree(objShape* shape);
+int32_t shapeFindSlot(objShape* shape, uint32_t symbol);
+void printShapeTree(objShape* shape, uint32_t depth);
+
+// Object attribute functions
+
+objAttrs* createObjAttrs(objClass* c);
+void freeObjAttrs(objAttrs* attrs);
+Value objAttrFind(objAttrs* attrs, uint32_t symbol);
+void objAttrSet(Object* obj, uint32_t symbol, Value value);
+
+#endif //CJ_2_OBJSHAPE_H
@@ -6,186 +6,107 @@
 #include "common.h"
 #include "errors.h"
 #include "stringHash.h"
+#include "objShape.h"
+#include "objClass.h"
+#include "slabAllocator.h"
 
 #include <string.h>
 #include <assert.h>
 #include <math.h>
 
-strValueHash* createStrValHashTable(uint32_t table_size) {
-    strValueHash* table = malloc(sizeof(strValueHash));
+static inline uint32_t symValSlot(uint32_t symbol, uint32_t tableSize) {
+    // Fibonacci hashing spreads dense symbol IDs across the table
+    return (symbol * 2654435769u) & (tableSize - 1);
+}
+
+symValueTable* createSymValTable(uint32_t tableSize) {
+    symValueTable* table = slabAlloc(sizeof(symValueTable));
     if (table == NULL) raiseExceptionByName("ObjHashError", "Memory allocation failed.\n");
-    table->table_size = table_size;
-    table->num_entries = 0;
-    table->history_max_entries = 0;
-    table->entries = calloc(table->table_size, sizeof(strValueEntry*));
+    table->tableSize = tableSize;
+    table->numEntries = 0;
+    table->entries = slabAlloc(sizeof(symValueEntry) * tableSize);
     if (table->entries == NULL) raiseExceptionByName("ObjHashError", "Memory allocation failed.\n");
-
+    for (uint32_t i = 0; i < tableSize; i++) table->entries[i].symbol = SYMBOL_NONE;
     return table;
 }
 
-void deleteStrValHashTable(strValueHash* table) {
+void deleteSymValTable(symValueTable* table) {
     assert(table != NULL);
-
-    for (uint32_t i = 0; i < table->table_size; i++) {
-        strValueEntry* entry = table->entries[i];
-        while (entry != NULL) {
-            strValueEntry* next = entry->next;
-            removeReference(entry->key);
-            free(entry);
-            entry = next;
-        }
-    }
-
-    free(table->entries);
-    free(table);
-}
-
-void strValResizeInsert(strValueHash* table, char* key, Value value) {
-    assert(table != NULL);
-    assert(key != NULL);
-
-    uint32_t pos = hashString(key) % table->table_size;
-    strValueEntry* entry = table->entries[pos];
-
-    while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
-            // Marking remove reference, replace Value.
-            Value removedValue = entry->value;
-            entry->value = value;
-
-//            GCRemoveRef(removedValue);
-            return;
-        }
-        entry = entry->next;
-    }
-
-    entry = malloc(sizeof(strValueEntry));
-    if (entry == NULL) raiseExceptionByName("ObjHashError", "Memory allocation for strObjTable entry failed");
-    entry->key = addReference(key);
-    entry->value = value;
-    entry->next = table->entries[pos];
-    table->entries[pos] = entry;
-
-    table->num_entries++;
-
-    if ((float)table->num_entries / (float)table->table_size > LOAD_FACTOR_THRESHOLD) strValResize(table);
+    slabFree(table->entries, sizeof(symValueEntry) * table->tableSize);
+    slabFree(table, sizeof(symValueTable));
 }
 
-void strValInsert(strValueHash* table, char* key, Value value) {
-    strValResizeInsert(table, key, value);
-    table->history_max_entries++;
-    if (table->history_max_entries >= UINT32_MAX-1)
-        raiseExceptionByName("ObjHashError", "StrObjTable history_max_entries overflow during insert");
-}
-
-Value strValFind(strValueHash* table, char* key) {
-    assert(table != NULL);
-    assert(key != NULL);
+static void symValResize(symValueTable* table) {
+    if (table->tableSize >= UINT32_MAX/2)
+        raiseExceptionByName("ObjHashError", "SymValTable exceeds max size during resize");
 
-    uint32_t pos = hashString(key) % table->table_size;
-    strValueEntry* entry = table->entries[pos];
+    uint32_t oldTableSize = table->tableSize;
+    symValueEntry* oldEntries = table->entries;
 
-    while (entry != NULL) {
-        if (strcmp(entry->key, key) == 0) {
-            return entry->value;
-        }
-        entry = entry->next;
+    table->tableSize *= 2;
+    table->entries = slabAlloc(sizeof(symValueEntry) * table->tableSize);
+    if (table->entries == NULL)
+        raiseExceptionByName("ObjHashError", "Memory allocation failed during SymValTable resize");
+    for (uint32_t i = 0; i < table->tableSize; i++) table->entries[i].symbol = SYMBOL_NONE;
+
+    uint32_t mask = table->tableSize - 1;
+    for (uint32_t i = 0; i < oldTableSize; i++) {
+        if (oldEntries[i].symbol == SYMBOL_NONE) continue;
+        uint32_t pos = symValSlot(oldEntries[i].symbol, table->tableSize);
+        while (table->entries[pos].symbol != SYMBOL_NONE) pos = (pos + 1) & mask;
+        table->entries[pos] = oldEntries[i];
     }
 
-    return INTERNAL_NULL_VAL;
+    slabFree(oldEntries, sizeof(symValueEntry) * oldTableSize);
 }
 
-void strValTableDeleteEntry(strValueHash* table, char* key) {
+void symValInsert(symValueTable* table, uint32_t symbol, Value value) {
     assert(table != NULL);
-    assert(key != NULL);
+    assert(symbol != SYMBOL_NONE);
 
-    uint32_t pos = hashString(key) % table->table_size;
-    strValueEntry** p = &(table->entries[pos]);
-
-    while (*p != NULL) {
-        if (strcmp((*p)->key, key) == 0) {
-            strValueEntry* entry = *p;
-            *p = entry->next;
-            removeReference(entry->key);
-            // GC remove reference
-            Value removedValue = entry->value;
-            free(entry);
-            table->num_entries--;
-
-//            GCRemoveRef(removedValue);
+    uint32_t mask = table->tableSize - 1;
+    uint32_t pos = symValSlot(symbol, table->tableSize);
+    while (table->entries[pos].symbol != SYMBOL_NONE) {
+        if (table->entries[pos].symbol == symbol) {
+            table->entries[pos].value = value;
             return;
         }
-        p = &((*p)->next);
+        pos = (pos + 1) & mask;
     }
-    raiseExceptionByName("ObjHashError", "Key not found in delete");
+    table->entries[pos].symbol = symbol;
+    table->entries[pos].value = value;
+    table->numEntries++;
+
+    if ((float)table->numEntries / (float)table->tableSize > LOAD_FACTOR_THRESHOLD) symValResize(table);
 }
 
-void strValResize(strValueHash* table) {
+Value symValFind(symValueTable* table, uint32_t symbol) {
     assert(table != NULL);
 
-    if (table->table_size >= UINT32_MAX/2)
-        raiseExceptionByName("ObjHashError", "StrObjTable exceeds max size during resize");
-
-    uint32_t old_table_size = table->table_size;
-    strValueEntry** old_entries = table->entries;
-
-    table->table_size *= 2;
-    table->num_entries = 0;
-    table->entries = calloc(table->table_size, sizeof(strValueEntry*));
-    if (table->entries == NULL)
-        raiseExceptionByName("ObjHashError", "Memory allocation failed during StrObjTable resize");
-
-    for (uint32_t i = 0; i < old_table_size; i++) {
-        strValueEntry* entry = old_entries[i];
-        while (entry != NULL) {
-            strValResizeInsert(table, entry->key, entry->value);
-            strValueEntry* next = entry->next;
-            removeReference(entry->key);
-            free(entry);
-            entry = next;
-        }
+    uint32_t mask = table->tableSize - 1;
+    uint32_t pos = symValSlot(symbol, table->tableSize);
+    symValueEntry* entries = table->entries;
+    while (entries[pos].symbol != SYMBOL_NONE) {
+        if (entries[pos].symbol == symbol) return entries[pos].value;
+        pos = (pos + 1) & mask;
     }
 
-    free(old_entries);
-}
-
-void printStrValHash(strValueHash* table, void (*printFunc)(Value)) {
-    for (uint32_t i = 0; i < table->table_size; i++) {
-        strValueEntry* entry = table->entries[i];
-        while (entry != NULL) {
-            if (printFunc == NULL) {
-                printf("Key: \"%s\"", entry->key);
-            } else {
-                printf("Key: \"%s\", ", entry->key);
-                printFunc(entry->value);
-                printf("\n");
-            }
-
-            entry = entry->next;
-        }
-    }
-    printf("Number of Entries: %u, Table Size: %u, History max entries: %u\n\n", table->num_entries, table->table_size, table->history_max_entries);
+    return INTERNAL_NULL_VAL;
 }
 
-void printStrValStructure(strValueHash* table) {
-    for (uint32_t i = 0; i < table->table_size; i++) {
-        strValueEntry* entry = table->entries[i];
-        if (entry != NULL) {
-            printf("[%u]: ", i);
+void printSymValTable(symValueTable* table, void (*printFunc)(Value)) {
+    for (uint32_t i = 0; i < table->tableSize; i++) {
+        symValueEntry* entry = &table->entries[i];
+        if (entry->symbol == SYMBOL_NONE) continue;
+        if (printFunc == NULL) {
+            printf("Key: \"%s\"", getSymbolName(entry->symbol));
         } else {
-            printf("[%u]: EMPTY", i);
-        }
-        while (entry != NULL) {
-            printf("\"%s\"", entry->key);
-
-            entry = entry->next;
-            if (entry != NULL) {
-                printf(" -> ");
-            }
+            printf("Key: \"%s\", ", getSymbolName(entry->symbol));
+            printFunc(entry->value);
+            printf("\n");
         }
-        printf("\n");
     }
-    printf("Number of Entries: %u, Table Size: %u\n\n", table->num_entries, table->table_size);
+    printf("Number of Entries: %u, Table Size: %u\n\n", table->numEntries, table->tableSize);
 }
 
 void printObjClass(objClass* oc) {
@@ -218,101 +139,58 @@ void printObjClass(objClass* oc) {
     printf(", className: \"%s\"]\n", oc->className);
 
     // Print attributes
-    strValueHash* table = oc->predefinedAttrs;
+    symValueTable* table = oc->predefinedAttrs;
     printf("Attributes:\n");
-    for (uint32_t i = 0; i < table->table_size; i++) {
-        strValueEntry* entry = table->entries[i];
-        while (entry != NULL) {
-            printf("    Key: \"%s\" -> ", entry->key);
-            printValue(entry->value);
-            printf("\n");
-
-            entry = entry->next;
-        }
+    for (uint32_t i = 0; i < table->tableSize; i++) {
+        symValueEntry* entry = &table->entries[i];
+        if (entry->symbol == SYMBOL_NONE) continue;
+        printf("    Key: \"%s\" -> ", getSymbolName(entry->symbol));
+        printValue(entry->value);
+        printf("\n");
     }
-    printf("    Number of Entries: %u, Table Size: %u\n\n", table->num_entries, table->table_size);
+    printf("    Number of Entries: %u, Table Size: %u\n\n", table->numEntries, table->tableSize);
 }
 
-void deleteObject(Object* obj) {
-    // Avoid freeing afterDefAttrs if is NULL (system defined class)
+// Frees the payload owned by the object, NULL payloads of half initialized objects are skipped
+void freeObjectPayload(Object* obj) {
+    // System defined classes carry no attribute storage
     if (!IS_SYSTEM_DEFINED_TYPE(obj->type)) {
-        strValueHash* table = obj->primValue.afterDefAttributes;
-
-        for (uint32_t i = 0; i < table->table_size; i++) {
-            strValueEntry* entry = table->entries[i];
-            while (entry != NULL) {
-                strValueEntry* next = entry->next;
-                removeReference(entry->key);
-                free(entry);
-                entry = next;
-            }
-        }
-
-        free(table->entries);
-        free(table);
-    } else {
-        switch (obj->type) {
-            case BUILTIN_CALLABLE:
-                deleteCallable(obj->primValue.call);
-                break;
-            case BUILTIN_STR:
-                removeReference(obj->primValue.str);
-                break;
-            case BUILTIN_LIST:
-                freeRuntimeList(obj->primValue.list);
-                break;
-            case BUILTIN_DICT:
-                freeRuntimeDict(obj->primValue.dict);
-                break;
-            case BUILTIN_SET:
-                freeRuntimeSet(obj->primValue.set);
-                break;
-            default:
-                break;
-        }
+        if (obj->primValue.attrs != NULL) freeObjAttrs(obj->primValue.attrs);
+        return;
     }
+    switch (obj->type) {
+        case BUILTIN_CALLABLE:
+            deleteCallable(obj->primValue.call);
+            break;
+        case BUILTIN_STR:
+            if (obj->primValue.str != NULL) removeReference(obj->primValue.str);
+            break;
+        case BUILTIN_LIST:
+            if (obj->primValue.list != NULL) freeRuntimeList(obj->primValue.list);
+            break;
+        case BUILTIN_DICT:
+            if (obj->primValue.dict != NULL) freeRuntimeDict(obj->primValue.dict);
+            break;
+        case BUILTIN_SET:
+            if (obj->primValue.set != NULL) freeRuntimeSet(obj->primValue.set);
+            break;
+        case BUILTIN_FLOAT_ARRAY:
+        case BUILTIN_INT_ARRAY:
+            if (obj->primValue.array != NULL) freeRuntimeArray(obj->primValue.array);
+            break;
+        default:
+            break;
+    }
+}
+
+void deleteObject(Object* obj) {
+    freeObjectPayload(obj);
     free(obj);
 }
 
 void deleteConst(Object* obj) {
     assert(obj != NULL);
-    // Avoid freeing afterDefAttrs if is NULL (system defined class)
-    if (!IS_SYSTEM_DEFINED_TYPE(obj->type)) {
-        strValueHash* table = obj->primValue.afterDefAttributes;
-
-        for (uint32_t i = 0; i < table->table_size; i++) {
-            strValueEntry* entry = table->entries[i];
-            while (entry != NULL) {
-                strValueEntry* next = entry->next;
-                removeReference(entry->key);
-                free(entry);
-                entry = next;
-            }
-        }
-
-        free(table->entries);
-        free(table);
-    } else {
-        switch (obj->type) {
-            case BUILTIN_CALLABLE:
-                deleteCallable(obj->primValue.call);
-                break;
-            case BUILTIN_STR:
-                removeReference(obj->primValue.str);
-                break;
-            case BUILTIN_LIST:
-                freeRuntimeList(obj->primValue.list);
-                break;
-            case BUILTIN_DICT:
-                freeRuntimeDict(obj->primValue.dict);
-                break;
-            case BUILTIN_SET:
-                freeRuntimeSet(obj->primValue.set);
-                break;
-            default:
-                break;
-        }
-    }
+    freeObjectPayload(obj);
 }
 
 void printPrimitiveValue(Value val) {
@@ -348,6 +226,10 @@ void printPrimitiveValue(Value val) {
         case BUILTIN_SET:
             printRuntimeSet(VALUE_SET_VALUE(val));
             break;
+        case BUILTIN_FLOAT_ARRAY:
+        case BUILTIN_INT_ARRAY:
+            printRuntimeArray(VALUE_ARRAY_VALUE(val), VALUE_ARRAY_IS_INT(val));
+            break;
         default:
             raiseExceptionByName("ParameterError", "Invalid primitive type");
             break;
@@ -374,16 +256,14 @@ void deleteCallable(callable* c) {
     free(c);
 }
 
-Value getAttr(Value val, char* name) {
+Value getAttr(Value val, uint32_t symbol) {
     if (IS_INTERNAL_NULL(val)) raiseExceptionByName("ObjHashError", "Null object called on get attr.");
     Value value = INTERNAL_NULL_VAL;
-    if (!IS_SYSTEM_DEFINED_TYPE(val.type)) value = strValFind(VALUE_ATTRS(val), name);
+    if (!IS_SYSTEM_DEFINED_TYPE(val.type)) value = objAttrFind(VALUE_ATTRS(val), symbol);
     if (!IS_INTERNAL_NULL(value)) return value;
-    objClass* p_class = VALUE_CLASS(val);
-    while (p_class != NULL && IS_INTERNAL_NULL(value)) {
-        value = CLASS_FIND_ATTR(p_class, name);
-        p_class = p_class->parentClass;
-    }
+    // Inherited attributes are already merged into the resolved table
+    objClass* c = VALUE_CLASS(val);
+    if (c != NULL) value = CLASS_FIND_ATTR(c, symbol);
     if (IS_INTERNAL_NULL(value)) {
         raiseExceptionByName("AttributeError", "Attribute not found.");
         return NONE_VAL;
@@ -391,19 +271,17 @@ Value getAttr(Value val, char* name) {
     return value;
 }
 
-Value ignoreNullGetAttr(Value val, char* name) {
+Value ignoreNullGetAttr(Value val, uint32_t symbol) {
     if (IS_INTERNAL_NULL(val)) {
         raiseExceptionByName("TypeError", "Null object called on get attr.");
         return NONE_VAL;
     }
     Value value = INTERNAL_NULL_VAL;
-    if (!IS_SYSTEM_DEFINED_TYPE(val.type)) value = strValFind(VALUE_ATTRS(val), name);
+    if (!IS_SYSTEM_DEFINED_TYPE(val.type)) value = objAttrFind(VALUE_ATTRS(val), symbol);
     if (!IS_INTERNAL_NULL(value)) return value;
-    objClass* p_class = VALUE_CLASS(val);
-    while (p_class != NULL && IS_INTERNAL_NULL(value)) {
-        value = CLASS_FIND_ATTR(p_class, name);
-        p_class = p_class->parentClass;
-    }
+    // Inherited attributes are already merged into the resolved table
+    objClass* c = VALUE_CLASS(val);
+    if (c != NULL) value = CLASS_FIND_ATTR(c, symbol);
     return value;
 }
 
@@ -7,12 +7,11 @@
 
 #include "primitiveVars.h"
 #include "chunk.h"
+#include "symbolTable.h"
 
 #include <stdint.h>
 
 #define LOAD_FACTOR_THRESHOLD 0.75
-#define CLASS_ADD_ATTR(c, attrName, attrValue) strValInsert((c)->predefinedAttrs, attrName, attrValue)
-#define CLASS_FIND_ATTR(c, attrName) strValFind((c)->predefinedAttrs, attrName)
 #define VALUE_TYPE(val) val.type
 
 #define NONE_VAL (Value) { .obj = NULL, .type = VAL_NONE }
@@ -32,19 +31,25 @@
 #define VALUE_LIST_VALUE(val) val.obj->primValue.list
 #define VALUE_DICT_VALUE(val) val.obj->primValue.dict
 #define VALUE_SET_VALUE(val) val.obj->primValue.set
-#define VALUE_ATTRS(val) val.obj->primValue.afterDefAttributes
+#define VALUE_ARRAY_VALUE(val) val.obj->primValue.array
+#define VALUE_ARRAY_IS_INT(val) (VALUE_TYPE(val) == BUILTIN_INT_ARRAY)
+#define VALUE_ATTRS(val) val.obj->primValue.attrs
 #define VALUE_CLASS(val) classArray[VALUE_TYPE(val)]
 #define VALUE_OBJ_VAL(val) val.obj
 #define VALUE_PTR_VAL(val) val.ptr
 
-#define IS_SYSTEM_DEFINED_CLASS(c) ((c)->classID < 10)
-#define IS_SYSTEM_DEFINED_TYPE(t) ((t) < 10)
+#define SYSTEM_DEFINED_TYPE_COUNT 12
+#define IS_SYSTEM_DEFINED_CLASS(c) ((c)->classID < SYSTEM_DEFINED_TYPE_COUNT)
+#define IS_SYSTEM_DEFINED_TYPE(t) ((t) < SYSTEM_DEFINED_TYPE_COUNT)
+#define IS_ARRAY_TYPE(t) ((t) == BUILTIN_FLOAT_ARRAY || (t) == BUILTIN_INT_ARRAY)
 #define IS_ITERABLE_VAL(val) ((val).type > 5)
 #define IS_MARKABLE_VAL(val) ((val).type > 3)
 
 
-typedef struct strValueHash strValueHash;
+typedef struct symValueTable symValueTable;
 typedef struct objClass objClass;
+typedef struct objShape objShape;
+typedef struct objAttrs objAttrs;
 
 typedef enum {
     // Internal null value
@@ -61,7 +66,10 @@ typedef enum {
     BUILTIN_DICT = 7,
     BUILTIN_SET = 8,
     // Exception
-    EXCEPTION = 9
+    EXCEPTION = 9,
+    // Unboxed numeric arrays
+    BUILTIN_FLOAT_ARRAY = 10,
+    BUILTIN_INT_ARRAY = 11
 } ValueType;
 
 typedef enum {
@@ -81,13 +89,16 @@ struct Object {
         runtimeList* list;
         runtimeDict* dict;
         runtimeSet* set;
-        strValueHash *afterDefAttributes;
+        runtimeArray* array;
+        objAttrs* attrs;
     } primValue;
-    Object* next;
+    // Mark and allocation state live in the bitmaps of the owning block
     uint16_t type;
-    uint16_t blockID;
-    bool marked;
-    bool isConst;
+    bool isConst : 1;
+    // Survived a collection, only traced by major collections
+    bool isOld : 1;
+    // Old object already in the remembered set
+    bool remembered : 1;
 };
 
 struct Value {
@@ -107,8 +118,35 @@ struct objClass {
     char* className;
     objClass* parentClass;
     Value initFunc;
-    strValueHash *predefinedAttrs;
+    symValueTable *predefinedAttrs;
+    symValueTable *resolvedAttrs; // Own and inherited attributes, NULL until resolved
+    Value operatorSlots[OPERATOR_SYMBOL_COUNT]; // Operator methods, valid while resolvedAttrs is set
     initFuncType initType;
+    objShape* rootShape; // NULL for system defined classes
+    uint32_t expectedSlotCount; // Largest slot count seen, used to presize new objects
+    bool immutableKey; // Objects may cache their hash, declared with 'immutable'
+};
+
+// Shape definition
+
+struct objShape {
+    uint32_t attrSymbol; // Attribute added by the transition into this shape, SYMBOL_NONE for root
+    uint32_t slotCount;
+    uint32_t* slotSymbols;
+    bool hasOperatorAttrs; // Some slot shadows a class operator method
+    objShape* parent;
+    objShape** transitions;
+    uint32_t transitionCount;
+    uint32_t transitionCapacity;
+};
+
+struct objAttrs {
+    objShape* shape; // NULL once the object falls back to dictionary mode
+    symValueTable* dictAttrs; // Only used in dictionary mode
+    uint32_t capacity;
+    uint32_t cachedHash; // Only valid if hasCachedHash, set for immutable key classes
+    bool hasCachedHash;
+    Value slots[];
 };
 
 // Builtin classes
@@ -120,43 +158,40 @@ extern objClass* stringClass;
 extern objClass* listClass;
 extern objClass* dictClass;
 extern objClass* setClass;
+extern objClass* floatArrayClass;
+extern objClass* intArrayClass;
 
-// strValueHash definition
+// symValueTable definition
 
-typedef struct strValueEntry {
-    char* key;
+typedef struct symValueEntry {
+    uint32_t symbol; // SYMBOL_NONE marks an empty entry
     Value value;
-    struct strValueEntry* next;
-} strValueEntry;
-
-struct strValueHash {
-    uint32_t table_size;
-    uint32_t num_entries;
-    uint32_t history_max_entries;
-    strValueEntry** entries;
+} symValueEntry;
+
+struct symValueTable {
+    uint32_t tableSize; // Power of two
+    uint32_t numEntries;
+    symValueEntry* entries;
 };
 
-// strValueHash functions
+// symValueTable functions
 
-strValueHash* createStrValHashTable(uint32_t table_size);
-void deleteStrValHashTable(strValueHash* table);
-void strValInsert(strValueHash* table, char* key, Value value);
-void strValResizeInsert(strValueHash* table, char* key, Value value);
-Value strValFind(strValueHash* table, char* key);
-void strValTableDeleteEntry(strValueHash* table, char* key);
-void strValResize(strValueHash* table);
-void printStrValHash(strValueHash* table, void (*printFunc)(Value));
-void printStrValStructure(strValueHash* table);
+symValueTable* createSymValTable(uint32_t tableSize);
+void deleteSymValTable(symValueTable* table);
+void symValInsert(symValueTable* table, uint32_t symbol, Value value);
+Value symValFind(symValueTable* table, uint32_t symbol);
+void printSymValTable(symValueTable* table, void (*printFunc)(Value));
 
 // Callable functions
 callable* createCallable(int in, uint8_t out, void* cFunc, Chunk* func, callableType type);
 void deleteCallable(callable* c);
 
 // Object functions
+void freeObjectPayload(Object* obj);
 void deleteObject(Object* obj); // Not to be used by user's runtime operations
 void deleteConst(Object* obj);
-Value getAttr(Value val, char* name);
-Value ignoreNullGetAttr(Value val, char* name);
+Value getAttr(Value val, uint32_t symbol);
+Value ignoreNullGetAttr(Value val, uint32_t symbol);
 
 void printPrimitiveValue(Value val);
 void printValue(Value val);
@@ -7,6 +7,7 @@
 #include "runtimeDS.h"
 #include "errors.h"
 #include "objClass.h"
+#include "objShape.h"
 #include "runtimeMemoryManager.h"
 
 void initObjectManager() {
@@ -24,12 +25,14 @@ Object* createConstObj(objClass* c) {
     Object* newObj = addConst();
     newObj->type = c->classID;
     if (IS_SYSTEM_DEFINED_CLASS(c)) {
-        newObj->primValue.afterDefAttributes = NULL;
+        newObj->primValue.attrs = NULL;
     } else {
-        newObj->primValue.afterDefAttributes = createStrValHashTable(OBJECT_ATTR_TABLE_INIT_SIZE);
+        newObj->primValue.attrs = createObjAttrs(c);
     }
-    newObj->marked = false;
     newObj->isConst = true;
+    // Constants are never collected, they behave like old objects
+    newObj->isOld = true;
+    newObj->remembered = false;
     return newObj;
 }
 
@@ -64,7 +67,7 @@ Object* createConstDictObject() {
 Object* createConstSetObject() {
     // Create object
     Object* newObj = createConstObj(setClass);
-    newObj->primValue.set = createRuntimeSet(RUNTIME_SET_INIT_SIZE);
+    newObj->primValue.set = createRuntimeSet();
     return newObj;
 }
 
@@ -75,11 +78,10 @@ Object* createRuntimeObj(objClass* c) {
 
     newObj->type = c->classID;
     if (IS_SYSTEM_DEFINED_CLASS(c)) {
-        newObj->primValue.afterDefAttributes = NULL;
+        newObj->primValue.attrs = NULL;
     } else {
-        newObj->primValue.afterDefAttributes = createStrValHashTable(OBJECT_ATTR_TABLE_INIT_SIZE);
+        newObj->primValue.attrs = createObjAttrs(c);
     }
-    newObj->marked = false;
     newObj->isConst = false;
     return newObj;
 }
@@ -104,6 +106,12 @@ Object* createRuntimeDictObject() {
 
 Object* createRuntimeSetObject() {
     Object* newObj = createRuntimeObj(setClass);
-    newObj->primValue.set = createRuntimeSet(RUNTIME_SET_INIT_SIZE);
+    newObj->primValue.set = createRuntimeSet();
+    return newObj;
+}
+
+Object* createRuntimeArrayObject(objClass* c, uint32_t size) {
+    Object* newObj = createRuntimeObj(c);
+    newObj->primValue.array = createRuntimeArray(size);
     return newObj;
 }
@@ -20,6 +20,7 @@ Object* createRuntimeStringObject(char* value);
 Object* createRuntimeListObject();
 Object* createRuntimeDictObject();
 Object* createRuntimeSetObject();
+Object* createRuntimeArrayObject(objClass* c, uint32_t size);
 
 
 #endif //CJ_2_OBJECTMANAGER_H
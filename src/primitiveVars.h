@@ -15,6 +15,7 @@ typedef struct Object Object;
 typedef struct runtimeList runtimeList;
 typedef struct runtimeDict runtimeDict;
 typedef struct runtimeSet runtimeSet;
+typedef struct runtimeArray runtimeArray;
 
 typedef Value (*cMethodType)(Value, Value*, int);
 
@@ -46,9 +47,11 @@ typedef struct callable {
 void freeRuntimeList(runtimeList* list);
 void freeRuntimeDict(runtimeDict* dict);
 void freeRuntimeSet(runtimeSet* set);
+void freeRuntimeArray(runtimeArray* array);
 
 void printRuntimeList(runtimeList* list);
 void printRuntimeDict(runtimeDict* dict);
 void printRuntimeSet(runtimeSet* set);
+void printRuntimeArray(runtimeArray* array, bool isInt);
 
 #endif //CJ_2_PRIMITIVEVARS_H
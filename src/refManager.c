@@ -41,7 +41,7 @@ void resizeRefTable(refTable* dict, uint32_t newSize) {
     dict->tableSize = newSize;
 }
 
-void refTableInsert(refTable* dict, char* key, uint16_t value) {
+void refTableInsert(refTable* dict, char* key, uint32_t value) {
     uint32_t hash = hashString(key) % dict->tableSize;
     refTableEntry* entry = dict->entries[hash];
     while (entry) {
@@ -79,7 +79,7 @@ bool refTableContains(refTable* dict, char* key) {
     return false;
 }
 
-uint16_t refTableGet(refTable* dict, char* key) {
+uint32_t refTableGet(refTable* dict, char* key) {
     uint32_t hash = hashString(key) % dict->tableSize;
     refTableEntry* entry = dict->entries[hash];
     while (entry) {
@@ -103,13 +103,13 @@ void freeRefTable(refTable* dict) {
     free(dict);
 }
 
-uint16_t getRefIndex(refTable* refTable, char* identifier) {
+uint32_t getRefIndex(refTable* refTable, char* identifier) {
     assert(refTable != NULL);
     // Check if object is already in refTable
     if (refTableContains(refTable, identifier)) return refTableGet(refTable, identifier);
     // If not, assign a new index and add to ref Table
-    if (refTable->numEntries >= UINT8_MAX-1) raiseExceptionByName("ReferenceTableError", "RefTable overflow");
-    uint16_t objIndex = refTable->numEntries;
+    if (refTable->numEntries >= UINT32_MAX-1) raiseExceptionByName("ReferenceTableError", "RefTable overflow");
+    uint32_t objIndex = refTable->numEntries;
     refTableInsert(refTable, identifier, objIndex);
     return objIndex;
 }
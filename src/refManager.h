@@ -11,7 +11,7 @@ typedef struct refTableEntry refTableEntry;
 
 struct refTableEntry {
     char* key;
-    uint16_t value;
+    uint32_t value;
     refTableEntry* next;
 };
 
@@ -23,8 +23,9 @@ typedef struct refTable {
 
 refTable* createRefTable(uint32_t size);
 
-uint16_t getRefIndex(refTable* refTable, char* identifier);
+uint32_t getRefIndex(refTable* refTable, char* identifier);
 bool refTableContains(refTable* dict, char* key);
+uint32_t refTableGet(refTable* dict, char* key);
 void freeRefTable(refTable* dict);
 void printRefTable(refTable* dict);
 
@@ -6,14 +6,16 @@
 #include "errors.h"
 #include "vm.h"
 #include "stringHash.h"
+#include "slabAllocator.h"
+#include "objectManager.h"
 
 #include <math.h>
 #include <string.h>
 
 runtimeList* createRuntimeList(uint32_t size) {
-    runtimeList* newList = (runtimeList*) malloc(sizeof(runtimeList));
+    runtimeList* newList = (runtimeList*) slabAlloc(sizeof(runtimeList));
     if (newList == NULL) raiseExceptionByName("ListError", "Failed to allocate memory for list.");
-    newList->list = (Value*) malloc(sizeof(Value) * size);
+    newList->list = (Value*) slabAlloc(sizeof(Value) * size);
     if (newList->list == NULL) raiseExceptionByName("ListError", "Failed to allocate memory for list elements.");
     newList->size = 0;
     newList->capacity = size;
@@ -25,10 +27,10 @@ void listAddElement(runtimeList* list, Value value) {
         if (list->size >= (UINT32_MAX/2))
             raiseExceptionByName("ListError", "List size exceeds maximum size during reallocation.");
         // Double the capacity if the list is full
-        list->capacity *= 2;
-        Value* newList = (Value*) realloc(list->list, sizeof(Value) * list->capacity);
+        Value* newList = (Value*) slabRealloc(list->list, sizeof(Value) * list->capacity, sizeof(Value) * list->capacity * 2);
         if (newList == NULL) raiseExceptionByName("ListError", "Failed to reallocate memory for list elements.");
         list->list = newList;
+        list->capacity *= 2;
     }
     list->list[list->size++] = value;
 }
@@ -48,10 +50,10 @@ void listInsertElement(runtimeList* list, uint32_t index, Value value) {
         if (list->size >= (UINT32_MAX/2))
             raiseExceptionByName("ListError", "List size exceeds maximum size during reallocation.");
         // Double the capacity if the list is full
-        list->capacity *= 2;
-        Value* newList = (Value*) realloc(list->list, sizeof(Value) * list->capacity);
+        Value* newList = (Value*) slabRealloc(list->list, sizeof(Value) * list->capacity, sizeof(Value) * list->capacity * 2);
         if (newList == NULL) raiseExceptionByName("ListError", "Failed to reallocate memory for list elements.");
         list->list = newList;
+        list->capacity *= 2;
     }
 
     // Shift all elements to the right of the index one position to the right
@@ -105,10 +107,164 @@ uint32_t listIndexOfElement(runtimeList* list, Value value) {
     return 0;
 }
 
+// Grows the list to hold at least capacity elements
+static void listReserve(runtimeList* list, uint32_t capacity) {
+    if (capacity <= list->capacity) return;
+    if (capacity >= (UINT32_MAX/2))
+        raiseExceptionByName("ListError", "List size exceeds maximum size during reallocation.");
+    uint32_t newCapacity = list->capacity * 2;
+    if (newCapacity < capacity) newCapacity = capacity;
+    Value* newList = (Value*) slabRealloc(list->list, sizeof(Value) * list->capacity, sizeof(Value) * newCapacity);
+    if (newList == NULL) raiseExceptionByName("ListError", "Failed to reallocate memory for list elements.");
+    list->list = newList;
+    list->capacity = newCapacity;
+}
+
+void listExtend(runtimeList* list, runtimeList* other) {
+    // Other may be the list itself
+    uint32_t otherSize = other->size;
+    listReserve(list, list->size + otherSize);
+    memmove(&list->list[list->size], other->list, sizeof(Value) * otherSize);
+    list->size += otherSize;
+}
+
+void listReverse(runtimeList* list) {
+    if (list->size < 2) return;
+    Value* low = list->list;
+    Value* high = list->list + list->size - 1;
+    while (low < high) {
+        Value temp = *low;
+        *low++ = *high;
+        *high-- = temp;
+    }
+}
+
+// Copies list[start, end) to the end of result, indices must already be in range
+void listSlice(runtimeList* result, runtimeList* list, uint32_t start, uint32_t end) {
+    if (start >= end) return;
+    listReserve(result, result->size + (end - start));
+    memcpy(&result->list[result->size], &list->list[start], sizeof(Value) * (end - start));
+    result->size += end - start;
+}
+
+// Sort
+
+typedef struct {
+    Value key;
+    Value value;
+} listSortItem;
+
+typedef enum {
+    SORT_NUMBER,
+    SORT_STRING,
+    SORT_GENERIC
+} listSortKind;
+
+#define LIST_SORT_RUN_SIZE 32
+
+static bool genericLess(Value a, Value b) {
+    if (vm->panic) return false;
+    if (VALUE_TYPE(a) == VAL_NUMBER && VALUE_TYPE(b) == VAL_NUMBER) return VALUE_NUMBER_VALUE(a) < VALUE_NUMBER_VALUE(b);
+    if (VALUE_TYPE(a) == BUILTIN_STR && VALUE_TYPE(b) == BUILTIN_STR) return strcmp(VALUE_STR_VALUE(a), VALUE_STR_VALUE(b)) < 0;
+    // Anything else must be ordered by a user defined _less
+    if (IS_SYSTEM_DEFINED_TYPE(VALUE_TYPE(a)) && IS_SYSTEM_DEFINED_TYPE(VALUE_TYPE(b))) {
+        raiseExceptionByName("TypeError", "List elements are not comparable");
+        return false;
+    }
+    Value result = binaryOperation(a, b, OP_LESS);
+    if (vm->panic) return false;
+    if (VALUE_TYPE(result) != VAL_BOOL) {
+        raiseExceptionByName("ValueError", "Result of _less is not a boolean");
+        return false;
+    }
+    return VALUE_BOOL_VALUE(result);
+}
+
+static inline bool sortItemLess(listSortKind kind, const listSortItem* a, const listSortItem* b) {
+    switch (kind) {
+        case SORT_NUMBER:
+            return VALUE_NUMBER_VALUE(a->key) < VALUE_NUMBER_VALUE(b->key);
+        case SORT_STRING:
+            return strcmp(VALUE_STR_VALUE(a->key), VALUE_STR_VALUE(b->key)) < 0;
+        default:
+            return genericLess(a->key, b->key);
+    }
+}
+
+// Stable merge sort: insertion sorted runs, then bottom-up merges between items and buffer
+static void mergeSortItems(listSortItem* items, listSortItem* buffer, uint32_t n, listSortKind kind) {
+    for (uint32_t runStart = 0; runStart < n; runStart += LIST_SORT_RUN_SIZE) {
+        uint32_t runEnd = runStart + LIST_SORT_RUN_SIZE < n ? runStart + LIST_SORT_RUN_SIZE : n;
+        for (uint32_t i = runStart + 1; i < runEnd; i++) {
+            listSortItem item = items[i];
+            uint32_t j = i;
+            while (j > runStart && sortItemLess(kind, &item, &items[j - 1])) {
+                items[j] = items[j - 1];
+                j--;
+            }
+            items[j] = item;
+        }
+    }
+    listSortItem* src = items;
+    listSortItem* dst = buffer;
+    for (uint32_t width = LIST_SORT_RUN_SIZE; width < n; width *= 2) {
+        for (uint32_t low = 0; low < n; low += 2 * width) {
+            uint32_t mid = low + width < n ? low + width : n;
+            uint32_t high = low + 2 * width < n ? low + 2 * width : n;
+            uint32_t i = low, j = mid, k = low;
+            // Take from the right run only when strictly smaller to keep equal keys in order
+            while (i < mid && j < high) dst[k++] = sortItemLess(kind, &src[j], &src[i]) ? src[j++] : src[i++];
+            while (i < mid) dst[k++] = src[i++];
+            while (j < high) dst[k++] = src[j++];
+        }
+        listSortItem* temp = src;
+        src = dst;
+        dst = temp;
+    }
+    if (src != items) memcpy(items, src, sizeof(listSortItem) * n);
+}
+
+// Sorts the list in place. keys is NULL to order by the elements themselves, or
+// holds one precomputed key per element. Keys must be kept reachable by the caller.
+void listSort(runtimeList* list, runtimeList* keys) {
+    uint32_t n = list->size;
+    if (n < 2) return;
+    listSortItem* items = (listSortItem*) malloc(sizeof(listSortItem) * n * 2);
+    if (items == NULL) raiseExceptionByName("ListError", "Failed to allocate memory for list sort.");
+    bool allNumbers = true;
+    bool allStrings = true;
+    for (uint32_t i = 0; i < n; i++) {
+        items[i].value = list->list[i];
+        items[i].key = keys == NULL ? list->list[i] : keys->list[i];
+        allNumbers = allNumbers && VALUE_TYPE(items[i].key) == VAL_NUMBER;
+        allStrings = allStrings && VALUE_TYPE(items[i].key) == BUILTIN_STR;
+    }
+    listSortKind kind = allNumbers ? SORT_NUMBER : (allStrings ? SORT_STRING : SORT_GENERIC);
+    // _less may modify the list and trigger collections while items holds the only copy of some elements,
+    // a copy of the elements sits on the VM stack until they are written back
+    Value* savedStackTop = vm->stackTop;
+    if (kind == SORT_GENERIC) {
+        Value values = OBJECT_VAL(createRuntimeListObject(), BUILTIN_LIST);
+        *vm->stackTop++ = values;
+        listSlice(VALUE_LIST_VALUE(values), list, 0, n);
+    }
+    mergeSortItems(items, items + n, n, kind);
+    if (!vm->panic) {
+        // _less may have modified the list
+        if (list->size != n) {
+            raiseExceptionByName("ValueError", "List modified during sort");
+        } else {
+            for (uint32_t i = 0; i < n; i++) list->list[i] = items[i].value;
+        }
+    }
+    vm->stackTop = savedStackTop;
+    free(items);
+}
+
 void freeRuntimeList(runtimeList* list) {
     // Free the list and the structure
-    free(list->list);
-    free(list);
+    slabFree(list->list, sizeof(Value) * list->capacity);
+    slabFree(list, sizeof(runtimeList));
 }
 
 void printRuntimeList(runtimeList* list) {
@@ -122,211 +278,978 @@ void printRuntimeList(runtimeList* list) {
     printf("]");
 }
 
-uint32_t hashObject(Value key) {
-    if (VALUE_TYPE(key) == VAL_NUMBER) { // Use number hashString
-        double num = VALUE_NUMBER_VALUE(key);
-        double r = fmod(num, (double) 1);
-        double epsilon = 1e-5; // Tolerance
-        while (fabs(r) >= epsilon) {
-            num *= 10;
-            r = fmod(num, (double) 1);
+// Array
+
+runtimeArray* createRuntimeArray(uint32_t size) {
+    runtimeArray* newArray = (runtimeArray*) slabAlloc(sizeof(runtimeArray));
+    if (newArray == NULL) raiseExceptionByName("ArrayError", "Failed to allocate memory for array.");
+    uint32_t capacity = size < RUNTIME_ARRAY_INIT_SIZE ? RUNTIME_ARRAY_INIT_SIZE : size;
+    // double and int64_t share a size, one buffer serves both element kinds
+    newArray->floats = (double*) slabCalloc(sizeof(double) * capacity);
+    if (newArray->floats == NULL) raiseExceptionByName("ArrayError", "Failed to allocate memory for array elements.");
+    newArray->size = size;
+    newArray->capacity = capacity;
+    return newArray;
+}
+
+static void arrayReserve(runtimeArray* array, uint32_t capacity) {
+    if (capacity <= array->capacity) return;
+    if (capacity >= (UINT32_MAX/2))
+        raiseExceptionByName("ArrayError", "Array size exceeds maximum size during reallocation.");
+    uint32_t newCapacity = array->capacity * 2;
+    if (newCapacity < capacity) newCapacity = capacity;
+    double* newElements = (double*) slabRealloc(array->floats, sizeof(double) * array->capacity, sizeof(double) * newCapacity);
+    if (newElements == NULL) raiseExceptionByName("ArrayError", "Failed to reallocate memory for array elements.");
+    array->floats = newElements;
+    array->capacity = newCapacity;
+}
+
+// New elements are zero
+void arrayResize(runtimeArray* array, uint32_t size) {
+    arrayReserve(array, size);
+    if (size > array->size) memset(array->floats + array->size, 0, sizeof(double) * (size - array->size));
+    array->size = size;
+}
+
+// intArray elements stay below 2^53 in magnitude, so every element converts to a number exactly
+#define INT_ARRAY_LIMIT ((int64_t) 1 << 53)
+
+static inline bool intArrayInRange(int64_t value) {
+    return value > -INT_ARRAY_LIMIT && value < INT_ARRAY_LIMIT;
+}
+
+// Converts a number to an intArray element, raises if it is not an integer
+static inline bool arrayToInt(double value, int64_t* result) {
+    if (!isfinite(value) || fabs(value) >= (double) INT_ARRAY_LIMIT) {
+        raiseExceptionByName("ValueError", "intArray element out of range");
+        return false;
+    }
+    double rounded = round(value);
+    if (fabs(value - rounded) >= 1e-9) {
+        raiseExceptionByName("TypeError", "intArray element must be an integer");
+        return false;
+    }
+    *result = (int64_t) rounded;
+    return true;
+}
+
+void arrayAddElement(runtimeArray* array, bool isInt, double value) {
+    int64_t intValue;
+    if (isInt && !arrayToInt(value, &intValue)) return;
+    if (array->size == array->capacity) arrayReserve(array, array->size + 1);
+    if (isInt) {
+        array->ints[array->size++] = intValue;
+    } else {
+        array->floats[array->size++] = value;
+    }
+}
+
+void arraySetElement(runtimeArray* array, bool isInt, uint32_t index, double value) {
+    if (index >= array->size) {
+        raiseExceptionByName("ParameterError", "Array index out of range");
+        return;
+    }
+    if (isInt) {
+        int64_t intValue;
+        if (arrayToInt(value, &intValue)) array->ints[index] = intValue;
+    } else {
+        array->floats[index] = value;
+    }
+}
+
+Value arrayGetElement(runtimeArray* array, bool isInt, uint32_t index) {
+    if (index >= array->size) {
+        raiseExceptionByName("ParameterError", "Array index out of range");
+        return NONE_VAL;
+    }
+    return NUMBER_VAL(isInt ? (double) array->ints[index] : array->floats[index]);
+}
+
+void arrayCopy(runtimeArray* dst, runtimeArray* src) {
+    arrayResize(dst, src->size);
+    memcpy(dst->floats, src->floats, sizeof(double) * src->size);
+}
+
+// Kernels keep four independent accumulators so the loops pipeline and vectorize.
+// Integer reductions are exact while they fit in int64_t and fall back to doubles otherwise.
+
+double arraySum(runtimeArray* array, bool isInt) {
+    uint32_t n = array->size;
+    uint32_t i = 0;
+    if (isInt) {
+        const int64_t* a = array->ints;
+        int64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        bool overflow = false;
+        for (; i + 4 <= n; i += 4) {
+            overflow |= __builtin_add_overflow(s0, a[i], &s0);
+            overflow |= __builtin_add_overflow(s1, a[i+1], &s1);
+            overflow |= __builtin_add_overflow(s2, a[i+2], &s2);
+            overflow |= __builtin_add_overflow(s3, a[i+3], &s3);
         }
-        return (uint32_t) num;
+        for (; i < n; i++) overflow |= __builtin_add_overflow(s0, a[i], &s0);
+        overflow |= __builtin_add_overflow(s0, s1, &s0);
+        overflow |= __builtin_add_overflow(s2, s3, &s2);
+        overflow |= __builtin_add_overflow(s0, s2, &s0);
+        if (!overflow) return (double) s0;
+        double sum = 0;
+        for (i = 0; i < n; i++) sum += (double) a[i];
+        return sum;
+    }
+    const double* a = array->floats;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i];
+        s1 += a[i+1];
+        s2 += a[i+2];
+        s3 += a[i+3];
+    }
+    for (; i < n; i++) s0 += a[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+double arrayDot(runtimeArray* x, runtimeArray* y, bool isInt) {
+    if (x->size != y->size) {
+        raiseExceptionByName("ParameterError", "Array sizes do not match");
+        return 0;
+    }
+    uint32_t n = x->size;
+    uint32_t i = 0;
+    if (isInt) {
+        const int64_t* a = x->ints;
+        const int64_t* b = y->ints;
+        int64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        int64_t p0, p1, p2, p3;
+        bool overflow = false;
+        for (; i + 4 <= n; i += 4) {
+            overflow |= __builtin_mul_overflow(a[i], b[i], &p0);
+            overflow |= __builtin_mul_overflow(a[i+1], b[i+1], &p1);
+            overflow |= __builtin_mul_overflow(a[i+2], b[i+2], &p2);
+            overflow |= __builtin_mul_overflow(a[i+3], b[i+3], &p3);
+            overflow |= __builtin_add_overflow(s0, p0, &s0);
+            overflow |= __builtin_add_overflow(s1, p1, &s1);
+            overflow |= __builtin_add_overflow(s2, p2, &s2);
+            overflow |= __builtin_add_overflow(s3, p3, &s3);
+        }
+        for (; i < n; i++) {
+            overflow |= __builtin_mul_overflow(a[i], b[i], &p0);
+            overflow |= __builtin_add_overflow(s0, p0, &s0);
+        }
+        overflow |= __builtin_add_overflow(s0, s1, &s0);
+        overflow |= __builtin_add_overflow(s2, s3, &s2);
+        overflow |= __builtin_add_overflow(s0, s2, &s0);
+        if (!overflow) return (double) s0;
+        double sum = 0;
+        for (i = 0; i < n; i++) sum += (double) a[i] * (double) b[i];
+        return sum;
+    }
+    const double* a = x->floats;
+    const double* b = y->floats;
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i+1] * b[i+1];
+        s2 += a[i+2] * b[i+2];
+        s3 += a[i+3] * b[i+3];
+    }
+    for (; i < n; i++) s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+static double arrayExtreme(runtimeArray* array, bool isInt, bool findMax) {
+    uint32_t n = array->size;
+    if (n == 0) {
+        raiseExceptionByName("ParameterError", "Array is empty");
+        return 0;
+    }
+    if (isInt) {
+        const int64_t* a = array->ints;
+        int64_t best = a[0];
+        if (findMax) {
+            for (uint32_t i = 1; i < n; i++) best = a[i] > best ? a[i] : best;
+        } else {
+            for (uint32_t i = 1; i < n; i++) best = a[i] < best ? a[i] : best;
+        }
+        return (double) best;
+    }
+    const double* a = array->floats;
+    double best = a[0];
+    if (findMax) {
+        for (uint32_t i = 1; i < n; i++) best = a[i] > best ? a[i] : best;
+    } else {
+        for (uint32_t i = 1; i < n; i++) best = a[i] < best ? a[i] : best;
+    }
+    return best;
+}
+
+double arrayMin(runtimeArray* array, bool isInt) {
+    return arrayExtreme(array, isInt, false);
+}
+
+double arrayMax(runtimeArray* array, bool isInt) {
+    return arrayExtreme(array, isInt, true);
+}
+
+void arrayScale(runtimeArray* array, bool isInt, double factor) {
+    uint32_t n = array->size;
+    if (isInt) {
+        int64_t intFactor;
+        if (!arrayToInt(factor, &intFactor)) return;
+        int64_t* a = array->ints;
+        // Check every product first so a failed scale leaves the array unchanged
+        for (uint32_t i = 0; i < n; i++) {
+            int64_t product;
+            if (__builtin_mul_overflow(a[i], intFactor, &product) || !intArrayInRange(product)) {
+                raiseExceptionByName("ValueError", "intArray element out of range");
+                return;
+            }
+        }
+        for (uint32_t i = 0; i < n; i++) a[i] *= intFactor;
+        return;
+    }
+    double* a = array->floats;
+    for (uint32_t i = 0; i < n; i++) a[i] *= factor;
+}
+
+void arrayAddScalar(runtimeArray* array, bool isInt, double value) {
+    uint32_t n = array->size;
+    if (isInt) {
+        int64_t intValue;
+        if (!arrayToInt(value, &intValue)) return;
+        int64_t* a = array->ints;
+        // Both operands are below 2^53, so only the range of the sum needs checking
+        for (uint32_t i = 0; i < n; i++) {
+            if (!intArrayInRange(a[i] + intValue)) {
+                raiseExceptionByName("ValueError", "intArray element out of range");
+                return;
+            }
+        }
+        for (uint32_t i = 0; i < n; i++) a[i] += intValue;
+        return;
+    }
+    double* a = array->floats;
+    for (uint32_t i = 0; i < n; i++) a[i] += value;
+}
+
+// Elementwise result = x + y or x * y, result may not alias x or y
+static void arrayElementwise(runtimeArray* result, runtimeArray* x, runtimeArray* y, bool isInt, bool multiply) {
+    if (x->size != y->size) {
+        raiseExceptionByName("ParameterError", "Array sizes do not match");
+        return;
+    }
+    uint32_t n = x->size;
+    arrayResize(result, n);
+    if (isInt) {
+        const int64_t* a = x->ints;
+        const int64_t* b = y->ints;
+        int64_t* r = result->ints;
+        bool overflow = false;
+        if (multiply) {
+            for (uint32_t i = 0; i < n; i++) overflow |= __builtin_mul_overflow(a[i], b[i], &r[i]) || !intArrayInRange(r[i]);
+        } else {
+            for (uint32_t i = 0; i < n; i++) overflow |= !intArrayInRange(r[i] = a[i] + b[i]);
+        }
+        if (overflow) raiseExceptionByName("ValueError", "intArray element out of range");
+        return;
+    }
+    const double* a = x->floats;
+    const double* b = y->floats;
+    double* r = result->floats;
+    if (multiply) {
+        for (uint32_t i = 0; i < n; i++) r[i] = a[i] * b[i];
+    } else {
+        for (uint32_t i = 0; i < n; i++) r[i] = a[i] + b[i];
+    }
+}
+
+void arrayAdd(runtimeArray* result, runtimeArray* x, runtimeArray* y, bool isInt) {
+    arrayElementwise(result, x, y, isInt, false);
+}
+
+void arrayMul(runtimeArray* result, runtimeArray* x, runtimeArray* y, bool isInt) {
+    arrayElementwise(result, x, y, isInt, true);
+}
+
+static int compareFloats(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+static int compareInts(const void* a, const void* b) {
+    int64_t x = *(const int64_t*) a;
+    int64_t y = *(const int64_t*) b;
+    return (x > y) - (x < y);
+}
+
+void arraySort(runtimeArray* array, bool isInt) {
+    if (array->size < 2) return;
+    qsort(array->floats, array->size, sizeof(double), isInt ? compareInts : compareFloats);
+}
+
+void freeRuntimeArray(runtimeArray* array) {
+    slabFree(array->floats, sizeof(double) * array->capacity);
+    slabFree(array, sizeof(runtimeArray));
+}
+
+void printRuntimeArray(runtimeArray* array, bool isInt) {
+    printf(isInt ? "i[" : "f[");
+    for (uint32_t i = 0; i < array->size; i++) {
+        if (isInt) {
+            printf("%lld", (long long) array->ints[i]);
+        } else {
+            printPrimitiveValue(NUMBER_VAL(array->floats[i]));
+        }
+        if (i != array->size - 1) printf(", ");
+    }
+    printf("]");
+}
+
+// Hash of a number, nearly equal numbers land on the same quantized value
+static inline uint32_t hashNumber(double num) {
+    uint64_t bits;
+    if (fabs(num) < 1e12) {
+        int64_t quantized = (int64_t) llround(num * 1e6);
+        memcpy(&bits, &quantized, sizeof(bits));
+    } else {
+        memcpy(&bits, &num, sizeof(bits));
+    }
+    // 64-bit finalizer mix
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    bits *= 0xc4ceb9fe1a85ec53ULL;
+    bits ^= bits >> 33;
+    return (uint32_t) bits;
+}
+
+uint32_t hashObject(Value key) {
+    if (VALUE_TYPE(key) == VAL_NUMBER) {
+        return hashNumber(VALUE_NUMBER_VALUE(key));
     } else if (VALUE_TYPE(key) == BUILTIN_STR) { // Use string hashString
         return hashString(VALUE_STR_VALUE(key));
-    } else { // Search for hashString function
-        Value objHashFunc = ignoreNullGetAttr(key, "hashString");
+    } else if (VALUE_TYPE(key) == VAL_BOOL) {
+        return VALUE_BOOL_VALUE(key) ? 1 : 0;
+    } else if (VALUE_TYPE(key) == VAL_NONE) {
+        return 0;
+    } else if (VALUE_TYPE(key) == BUILTIN_CALLABLE) { // Callables compare by identity
+        return (uint32_t) ((uintptr_t) key.obj >> 4);
+    } else if (IS_SYSTEM_DEFINED_TYPE(VALUE_TYPE(key))) { // Search for hashString function
+        Value objHashFunc = ignoreNullGetAttr(key, SYMBOL_HASH_STRING);
         if (IS_INTERNAL_NULL(objHashFunc)) raiseExceptionByName("DictError", "Hash function undefined.");
         Value valueObj = execInput(objHashFunc, key, NULL, 0);
         if (VALUE_TYPE(valueObj) != VAL_NUMBER)
             raiseExceptionByName("DictError", "Non number type hashString function return.");
         return (uint32_t) VALUE_NUMBER_VALUE(valueObj);
+    } else { // User object, use hashString if defined, identity otherwise
+        objAttrs* attrs = VALUE_ATTRS(key);
+        if (attrs->hasCachedHash) return attrs->cachedHash;
+        uint32_t hash;
+        Value objHashFunc = ignoreNullGetAttr(key, SYMBOL_HASH_STRING);
+        if (IS_INTERNAL_NULL(objHashFunc)) {
+            hash = (uint32_t) ((uintptr_t) key.obj >> 4);
+        } else {
+            Value valueObj = execInput(objHashFunc, key, NULL, 0);
+            if (VALUE_TYPE(valueObj) != VAL_NUMBER)
+                raiseExceptionByName("DictError", "Non number type hashString function return.");
+            hash = (uint32_t) VALUE_NUMBER_VALUE(valueObj);
+        }
+        if (VALUE_CLASS(key)->immutableKey) {
+            attrs->cachedHash = hash;
+            attrs->hasCachedHash = true;
+        }
+        return hash;
+    }
+}
+
+// Control bytes are matched eight at a time as a 64-bit word
+#define DICT_GROUP_WIDTH 8
+#define DICT_LSBS 0x0101010101010101ULL
+#define DICT_MSBS 0x8080808080808080ULL
+
+#define DICT_H1(hash) ((hash) >> 7)
+#define DICT_H2(hash) ((uint8_t) ((hash) & 0x7F))
+
+static inline uint32_t mixHash(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static inline uint64_t loadGroup(const uint8_t* ctrl) {
+    uint64_t group;
+    memcpy(&group, ctrl, sizeof(group));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    group = __builtin_bswap64(group);
+#endif
+    return group;
+}
+
+// Sets the high bit of every byte equal to tag, may report false positives which are filtered by the stored hash
+static inline uint64_t groupMatch(uint64_t group, uint8_t tag) {
+    uint64_t x = group ^ (DICT_LSBS * tag);
+    return (x - DICT_LSBS) & ~x & DICT_MSBS;
+}
+
+static inline uint64_t groupMatchEmpty(uint64_t group) {
+    return group & (~group << 6) & DICT_MSBS;
+}
+
+static inline uint64_t groupMatchEmptyOrDeleted(uint64_t group) {
+    return group & DICT_MSBS;
+}
+
+static inline uint32_t groupFirstIndex(uint64_t mask) {
+    return (uint32_t) __builtin_ctzll(mask) >> 3;
+}
+
+static inline uint32_t dictTableSizeFor(uint32_t size) {
+    uint32_t tableSize = DICT_GROUP_WIDTH;
+    while (tableSize < size) {
+        if (tableSize >= (UINT32_MAX/2)) raiseExceptionByName("DictError", "Dict size exceeds maximum size during reallocation");
+        tableSize *= 2;
     }
+    return tableSize;
 }
 
-#define MAX_LOAD_FACTOR 0.75
+// Max load factor of 7/8. Deleted index slots always belong to removed entries,
+// so a full entry array also bounds the index table load.
+static inline uint32_t dictEntryCapacityFor(uint32_t tableSize) {
+    return tableSize - tableSize / 8;
+}
+
+static void initDictIndex(runtimeDict* dict, uint32_t tableSize) {
+    dict->tableSize = tableSize;
+    dict->numDeleted = 0;
+    dict->ctrl = (uint8_t*) slabAlloc(tableSize);
+    dict->indices = (uint32_t*) slabAlloc(sizeof(uint32_t) * tableSize);
+    if (dict->ctrl == NULL || dict->indices == NULL) raiseExceptionByName("DictError", "Failed to allocate memory for dict index.");
+    memset(dict->ctrl, DICT_CTRL_EMPTY, tableSize);
+}
 
 runtimeDict* createRuntimeDict(uint32_t size) {
-    runtimeDict* dict = (runtimeDict*) malloc(sizeof(runtimeDict));
+    runtimeDict* dict = (runtimeDict*) slabAlloc(sizeof(runtimeDict));
     if (dict == NULL) raiseExceptionByName("DictError", "Failed to allocate memory for dict.");
-    dict->tableSize = size;
+    initDictIndex(dict, dictTableSizeFor(size));
     dict->numEntries = 0;
-    dict->entries = (runtimeDictEntry**) calloc(size, sizeof(runtimeDictEntry*));
+    dict->entryCount = 0;
+    dict->entryCapacity = dictEntryCapacityFor(dict->tableSize);
+    dict->entries = (runtimeDictEntry*) slabAlloc(sizeof(runtimeDictEntry) * dict->entryCapacity);
     if (dict->entries == NULL) raiseExceptionByName("DictError", "Failed to allocate memory for dict entries.");
     return dict;
 }
 
-void resizeRuntimeDict(runtimeDict* dict, uint32_t newSize) {
-    runtimeDictEntry** newEntries = (runtimeDictEntry**) calloc(newSize, sizeof(runtimeDictEntry*));
-    if (newEntries == NULL)
-        raiseExceptionByName("DictError", "Failed to allocate memory for dict entries during resize");
-    // Rehash all entries
-    for (uint32_t i = 0; i < dict->tableSize; ++i) {
-        runtimeDictEntry* entry = dict->entries[i];
-        while (entry != NULL) {
-            uint32_t newHash = hashObject(entry->key) % newSize;
-            runtimeDictEntry* nextEntry = entry->next;
-            entry->next = newEntries[newHash];
-            newEntries[newHash] = entry;
-            entry = nextEntry;
+// Returns the index slot pointing at key, or -1. strKey compares string contents instead of calling compareValue.
+static int64_t dictFindSlot(runtimeDict* dict, uint32_t hash, Value key, const char* strKey) {
+    uint32_t mask = dict->tableSize - 1;
+    uint32_t pos = DICT_H1(hash) & mask & ~(DICT_GROUP_WIDTH - 1);
+    uint8_t tag = DICT_H2(hash);
+    // Triangular probing over groups visits every group of a power of two table
+    for (uint32_t stride = DICT_GROUP_WIDTH; ; stride += DICT_GROUP_WIDTH) {
+        uint64_t group = loadGroup(dict->ctrl + pos);
+        for (uint64_t match = groupMatch(group, tag); match != 0; match &= match - 1) {
+            uint32_t i = pos + groupFirstIndex(match);
+            if (!DICT_SLOT_IS_FULL(dict, i)) continue;
+            runtimeDictEntry* entry = &dict->entries[dict->indices[i]];
+            if (entry->hash != hash) continue;
+            if (strKey != NULL) {
+                if (VALUE_TYPE(entry->key) == BUILTIN_STR && strcmp(VALUE_STR_VALUE(entry->key), strKey) == 0) return i;
+            } else if (compareValue(entry->key, key)) {
+                return i;
+            }
         }
+        // A group with an empty slot ends every probe sequence that reached it
+        if (groupMatchEmpty(group) != 0) return -1;
+        pos = (pos + stride) & mask;
+    }
+}
+
+static uint32_t dictFindFreeSlot(runtimeDict* dict, uint32_t hash) {
+    uint32_t mask = dict->tableSize - 1;
+    uint32_t pos = DICT_H1(hash) & mask & ~(DICT_GROUP_WIDTH - 1);
+    for (uint32_t stride = DICT_GROUP_WIDTH; ; stride += DICT_GROUP_WIDTH) {
+        uint64_t match = groupMatchEmptyOrDeleted(loadGroup(dict->ctrl + pos));
+        if (match != 0) return pos + groupFirstIndex(match);
+        pos = (pos + stride) & mask;
     }
+}
 
-    free(dict->entries);
-    dict->entries = newEntries;
-    dict->tableSize = newSize;
+static inline void dictIndexEntry(runtimeDict* dict, uint32_t entryIndex) {
+    uint32_t hash = dict->entries[entryIndex].hash;
+    uint32_t i = dictFindFreeSlot(dict, hash);
+    if (dict->ctrl[i] == DICT_CTRL_DELETED) dict->numDeleted--;
+    dict->ctrl[i] = DICT_H2(hash);
+    dict->indices[i] = entryIndex;
+}
+
+// Compacts removed entries out of the entry array and rebuilds the index table
+void resizeRuntimeDict(runtimeDict* dict, uint32_t newSize) {
+    uint32_t liveCount = 0;
+    for (uint32_t i = 0; i < dict->entryCount; i++) {
+        if (DICT_ENTRY_IS_LIVE(&dict->entries[i])) dict->entries[liveCount++] = dict->entries[i];
+    }
+    dict->entryCount = liveCount;
+    uint32_t newCapacity = dictEntryCapacityFor(newSize);
+    if (newCapacity != dict->entryCapacity) {
+        runtimeDictEntry* newEntries = (runtimeDictEntry*) slabRealloc(dict->entries, sizeof(runtimeDictEntry) * dict->entryCapacity, sizeof(runtimeDictEntry) * newCapacity);
+        if (newEntries == NULL) raiseExceptionByName("DictError", "Failed to allocate memory for dict entries during resize");
+        dict->entries = newEntries;
+        dict->entryCapacity = newCapacity;
+    }
+    // tableSize is still the old size until initDictIndex
+    slabFree(dict->ctrl, dict->tableSize);
+    slabFree(dict->indices, sizeof(uint32_t) * dict->tableSize);
+    initDictIndex(dict, newSize);
+    // Reinsert using stored hashes
+    for (uint32_t i = 0; i < liveCount; i++) dictIndexEntry(dict, i);
 }
 
 void dictInsertElement(runtimeDict* dict, Value key, Value value) {
-    uint32_t hash = hashObject(key) % dict->tableSize;
-    runtimeDictEntry* entry = dict->entries[hash];
-    while (entry) {
-        if (compareValue(entry->key, key)) {
-            entry->value = value;  // Overwrite Value if key already exists
-            return;
+    uint32_t hash = mixHash(hashObject(key));
+    int64_t found = dictFindSlot(dict, hash, key, NULL);
+    if (found >= 0) {
+        dict->entries[dict->indices[found]].value = value;  // Overwrite Value if key already exists
+        return;
+    }
+    if (dict->entryCount == dict->entryCapacity) {
+        // Grow when live entries fill half the table, otherwise only compact removed entries
+        if (dict->numEntries * 2 >= dict->tableSize) {
+            if (dict->tableSize >= (UINT32_MAX/2))
+                raiseExceptionByName("DictError", "Dict size exceeds maximum size during reallocation");
+            resizeRuntimeDict(dict, dict->tableSize * 2);
+        } else {
+            resizeRuntimeDict(dict, dict->tableSize);
         }
-        entry = entry->next;
     }
-    // Key does not exist in dict, create new entry
-    entry = (runtimeDictEntry*) malloc(sizeof(runtimeDictEntry));
-    if (entry == NULL) raiseExceptionByName("DictError", "Failed to allocate memory for dict entry");
+    uint32_t entryIndex = dict->entryCount++;
+    runtimeDictEntry* entry = &dict->entries[entryIndex];
     entry->key = key;
     entry->value = value;
-    entry->next = dict->entries[hash];  // Insert at head of linked list
-    dict->entries[hash] = entry;
+    entry->hash = hash;
+    dictIndexEntry(dict, entryIndex);
     dict->numEntries++;
-
-    // Check if resize is needed
-    if ((float)dict->numEntries / (float) dict->tableSize > MAX_LOAD_FACTOR) {
-        if (dict->tableSize >= (UINT32_MAX/2))
-            raiseExceptionByName("DictError", "Dict size exceeds maximum size during reallocation");
-        resizeRuntimeDict(dict, dict->tableSize * 2);
-    }
 }
 
 Value dictGetElement(runtimeDict* dict, Value key) {
-    uint32_t hash = hashObject(key) % dict->tableSize;
-    runtimeDictEntry* entry = dict->entries[hash];
-    while (entry) {
-        if (compareValue(entry->key, key)) return entry->value;
-        entry = entry->next;
-    }
+    int64_t i = dictFindSlot(dict, mixHash(hashObject(key)), key, NULL);
+    if (i >= 0) return dict->entries[dict->indices[i]].value;
     raiseExceptionByName("ParameterError", "Key not found in dictionary");
     return NONE_VAL;
 }
 
+Value* dictGetValueRef(runtimeDict* dict, Value key) {
+    int64_t i = dictFindSlot(dict, mixHash(hashObject(key)), key, NULL);
+    if (i >= 0) return &dict->entries[dict->indices[i]].value;
+    return NULL;
+}
+
 bool dictContainsElement(runtimeDict* dict, Value key) {
-    uint32_t hash = hashObject(key) % dict->tableSize;
-    runtimeDictEntry* entry = dict->entries[hash];
-    while (entry) {
-        if (compareValue(entry->key, key)) return true;
-        entry = entry->next;
-    }
-    return false;
+    return dictFindSlot(dict, mixHash(hashObject(key)), key, NULL) >= 0;
 }
 
 void dictRemoveElement(runtimeDict* dict, Value key) {
-    uint32_t hash = hashObject(key) % dict->tableSize;
-    runtimeDictEntry* entry = dict->entries[hash];
-    runtimeDictEntry* prevEntry = NULL;
-    while (entry) {
-        if (compareValue(entry->key, key)) {
-            if (prevEntry) {
-                prevEntry->next = entry->next;
-            } else {
-                dict->entries[hash] = entry->next;
-            }
-            free(entry);
-            dict->numEntries--;
+    int64_t i = dictFindSlot(dict, mixHash(hashObject(key)), key, NULL);
+    if (i < 0) {
+        raiseExceptionByName("ParameterError", "Key not found in dictionary");
+        return;
+    }
+    runtimeDictEntry* entry = &dict->entries[dict->indices[i]];
+    entry->key = INTERNAL_NULL_VAL;
+    entry->value = INTERNAL_NULL_VAL;
+    // No probe has passed a group that still has an empty slot, so the slot can become empty again
+    uint32_t groupStart = (uint32_t) i & ~(DICT_GROUP_WIDTH - 1);
+    if (groupMatchEmpty(loadGroup(dict->ctrl + groupStart)) != 0) {
+        dict->ctrl[i] = DICT_CTRL_EMPTY;
+    } else {
+        dict->ctrl[i] = DICT_CTRL_DELETED;
+        dict->numDeleted++;
+    }
+    dict->numEntries--;
+}
 
-            return;
+bool dictIterateNext(runtimeDict* dict, uint32_t* cursor, Value* key) {
+    // Resume from entry cursor, yields keys in insertion order
+    while (*cursor < dict->entryCount) {
+        runtimeDictEntry* entry = &dict->entries[(*cursor)++];
+        if (DICT_ENTRY_IS_LIVE(entry)) {
+            *key = entry->key;
+            return true;
         }
-        prevEntry = entry;
-        entry = entry->next;
     }
-    raiseExceptionByName("ParameterError", "Key not found in dictionary");
+    return false;
 }
 
 Value dictStrGet(runtimeDict* dict, char* key) {
-    uint32_t hash = hashString(key) % dict->tableSize;
-    runtimeDictEntry* entry = dict->entries[hash];
-    while (entry) {
-        if (strcmp(VALUE_STR_VALUE(entry->key), key) == 0) return entry->key;
-        entry = entry->next;
-    }
+    int64_t i = dictFindSlot(dict, mixHash(hashString(key)), INTERNAL_NULL_VAL, key);
+    if (i >= 0) return dict->entries[dict->indices[i]].key;
     return INTERNAL_NULL_VAL;
 }
 
 Value dictNumGet(runtimeDict* dict, double key) {
-    double num = key;
-    double r = fmod(num, (double) 1);
-    double epsilon = 1e-5; // Tolerance
-    while (fabs(r) >= epsilon) {
-        num *= 10;
-        r = fmod(num, (double) 1);
-    }
-    uint32_t hash = (uint32_t) num % dict->tableSize;
-    runtimeDictEntry* entry = dict->entries[hash];
-    while (entry) {
-        if (VALUE_NUMBER_VALUE(entry->key) == key) return entry->key;
-        entry = entry->next;
-    }
+    int64_t i = dictFindSlot(dict, mixHash(hashNumber(key)), NUMBER_VAL(key), NULL);
+    if (i >= 0) return dict->entries[dict->indices[i]].key;
     return INTERNAL_NULL_VAL;
 }
 
 void freeRuntimeDict(runtimeDict* dict) {
-    for (uint32_t i = 0; i < dict->tableSize; i++) {
-        runtimeDictEntry* entry = dict->entries[i];
-        while (entry != NULL) {
-            runtimeDictEntry* temp = entry;
-            entry = entry->next;
-            free(temp);
-        }
-    }
-    free(dict->entries);
-    free(dict);
+    slabFree(dict->ctrl, dict->tableSize);
+    slabFree(dict->indices, sizeof(uint32_t) * dict->tableSize);
+    slabFree(dict->entries, sizeof(runtimeDictEntry) * dict->entryCapacity);
+    slabFree(dict, sizeof(runtimeDict));
 }
 
-runtimeSet* createRuntimeSet(uint32_t size) {
-    runtimeSet* set = (runtimeSet*) malloc(sizeof(runtimeSet));
+// Set
+
+// Returns true if key is a number that can live in the bitset, n receives its integer value
+static inline bool setBitsetKey(Value key, uint32_t* n) {
+    if (VALUE_TYPE(key) != VAL_NUMBER) return false;
+    double num = VALUE_NUMBER_VALUE(key);
+    double rounded = floor(num + 0.5);
+    if (fabs(num - rounded) >= 1e-9 || rounded < 0 || rounded >= SET_BITSET_MAX_SIZE) return false;
+    *n = (uint32_t) rounded;
+    return true;
+}
+
+runtimeSet* createRuntimeSet() {
+    runtimeSet* set = (runtimeSet*) slabAlloc(sizeof(runtimeSet));
     if (set == NULL) raiseExceptionByName("SetError", "Failed to allocate memory for set");
-    set->dict = createRuntimeDict(size);
+    // Sets start out as empty bitsets
+    set->tableSize = 0;
+    set->numEntries = 0;
+    set->numDeleted = 0;
+    set->ctrl = NULL;
+    set->entries = NULL;
+    set->bits = NULL;
+    set->bitWords = 0;
     return set;
 }
 
+static void initSetTable(runtimeSet* set, uint32_t tableSize) {
+    set->tableSize = tableSize;
+    set->numEntries = 0;
+    set->numDeleted = 0;
+    set->ctrl = (uint8_t*) slabAlloc(tableSize);
+    set->entries = (runtimeSetEntry*) slabAlloc(sizeof(runtimeSetEntry) * tableSize);
+    if (set->ctrl == NULL || set->entries == NULL) raiseExceptionByName("SetError", "Failed to allocate memory for set entries");
+    memset(set->ctrl, DICT_CTRL_EMPTY, tableSize);
+}
+
+// Returns the slot holding key, or -1
+static int64_t setFindSlot(runtimeSet* set, uint32_t hash, Value key) {
+    uint32_t mask = set->tableSize - 1;
+    uint32_t pos = DICT_H1(hash) & mask & ~(DICT_GROUP_WIDTH - 1);
+    uint8_t tag = DICT_H2(hash);
+    for (uint32_t stride = DICT_GROUP_WIDTH; ; stride += DICT_GROUP_WIDTH) {
+        uint64_t group = loadGroup(set->ctrl + pos);
+        for (uint64_t match = groupMatch(group, tag); match != 0; match &= match - 1) {
+            uint32_t i = pos + groupFirstIndex(match);
+            if (SET_SLOT_IS_FULL(set, i) && set->entries[i].hash == hash && compareValue(set->entries[i].key, key)) return i;
+        }
+        if (groupMatchEmpty(group) != 0) return -1;
+        pos = (pos + stride) & mask;
+    }
+}
+
+static uint32_t setFindFreeSlot(runtimeSet* set, uint32_t hash) {
+    uint32_t mask = set->tableSize - 1;
+    uint32_t pos = DICT_H1(hash) & mask & ~(DICT_GROUP_WIDTH - 1);
+    for (uint32_t stride = DICT_GROUP_WIDTH; ; stride += DICT_GROUP_WIDTH) {
+        uint64_t match = groupMatchEmptyOrDeleted(loadGroup(set->ctrl + pos));
+        if (match != 0) return pos + groupFirstIndex(match);
+        pos = (pos + stride) & mask;
+    }
+}
+
+static inline void setFillSlot(runtimeSet* set, uint32_t i, Value key, uint32_t hash) {
+    if (set->ctrl[i] == DICT_CTRL_DELETED) set->numDeleted--;
+    set->ctrl[i] = DICT_H2(hash);
+    set->entries[i].key = key;
+    set->entries[i].hash = hash;
+    set->numEntries++;
+}
+
+static void resizeRuntimeSet(runtimeSet* set, uint32_t newSize) {
+    uint32_t oldSize = set->tableSize;
+    uint8_t* oldCtrl = set->ctrl;
+    runtimeSetEntry* oldEntries = set->entries;
+    initSetTable(set, newSize);
+    // Reinsert using stored hashes, drops deleted slots
+    for (uint32_t i = 0; i < oldSize; i++) {
+        if (oldCtrl[i] >= 0x80) continue;
+        setFillSlot(set, setFindFreeSlot(set, oldEntries[i].hash), oldEntries[i].key, oldEntries[i].hash);
+    }
+    slabFree(oldCtrl, oldSize);
+    slabFree(oldEntries, sizeof(runtimeSetEntry) * oldSize);
+}
+
+// Makes room for one more element in hash mode
+static inline void setReserve(runtimeSet* set) {
+    if ((uint64_t) (set->numEntries + set->numDeleted + 1) * 8 <= (uint64_t) set->tableSize * 7) return;
+    // Grow when live elements fill half the table, otherwise only clear deleted slots
+    if (set->numEntries * 2 >= set->tableSize) {
+        if (set->tableSize >= (UINT32_MAX/2)) raiseExceptionByName("SetError", "Set size exceeds maximum size during reallocation");
+        resizeRuntimeSet(set, set->tableSize * 2);
+    } else {
+        resizeRuntimeSet(set, set->tableSize);
+    }
+}
+
+// Inserts a key known to be absent
+static inline void setInsertNew(runtimeSet* set, Value key, uint32_t hash) {
+    setReserve(set);
+    setFillSlot(set, setFindFreeSlot(set, hash), key, hash);
+}
+
+static inline uint32_t setBitsetHash(uint32_t n) {
+    return mixHash(hashNumber((double) n));
+}
+
+// Moves a bitset into a hash table, done once the set holds anything other than small integers
+static void setConvertToTable(runtimeSet* set, uint32_t minSize) {
+    uint64_t* bits = set->bits;
+    uint32_t bitWords = set->bitWords;
+    uint32_t count = set->numEntries;
+    if (minSize < count + 1) minSize = count + 1;
+    initSetTable(set, dictTableSizeFor(minSize + minSize / 4));
+    for (uint32_t w = 0; w < bitWords; w++) {
+        for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+            uint32_t n = w * 64 + (uint32_t) __builtin_ctzll(word);
+            uint32_t hash = setBitsetHash(n);
+            setFillSlot(set, setFindFreeSlot(set, hash), NUMBER_VAL(n), hash);
+        }
+    }
+    slabFree(bits, sizeof(uint64_t) * bitWords);
+    set->bits = NULL;
+    set->bitWords = 0;
+}
+
+static void setGrowBits(runtimeSet* set, uint32_t words) {
+    uint64_t* newBits = (uint64_t*) slabRealloc(set->bits, sizeof(uint64_t) * set->bitWords, sizeof(uint64_t) * words);
+    if (newBits == NULL) raiseExceptionByName("SetError", "Failed to allocate memory for set bitset");
+    memset(newBits + set->bitWords, 0, sizeof(uint64_t) * (words - set->bitWords));
+    set->bits = newBits;
+    set->bitWords = words;
+}
+
 void setInsertElement(runtimeSet* set, Value key) {
-    dictInsertElement(set->dict, key, INTERNAL_NULL_VAL);
+    if (SET_IS_BITSET(set)) {
+        uint32_t n;
+        // Stay a bitset while elements are dense enough
+        if (setBitsetKey(key, &n) && n < (set->numEntries + 1) * SET_BITSET_DENSITY + 64) {
+            uint32_t word = n / 64;
+            if (word >= set->bitWords) {
+                uint32_t words = set->bitWords == 0 ? 1 : set->bitWords;
+                while (words <= word) words *= 2;
+                setGrowBits(set, words);
+            }
+            uint64_t bit = (uint64_t) 1 << (n % 64);
+            if (!(set->bits[word] & bit)) {
+                set->bits[word] |= bit;
+                set->numEntries++;
+            }
+            return;
+        }
+        setConvertToTable(set, RUNTIME_SET_INIT_SIZE);
+    }
+    uint32_t hash = mixHash(hashObject(key));
+    if (setFindSlot(set, hash, key) >= 0) return;
+    setInsertNew(set, key, hash);
 }
 
 bool setContainsElement(runtimeSet* set, Value key) {
-    return dictContainsElement(set->dict, key);
+    if (SET_IS_BITSET(set)) {
+        uint32_t n;
+        if (!setBitsetKey(key, &n) || n / 64 >= set->bitWords) return false;
+        return (set->bits[n / 64] >> (n % 64)) & 1;
+    }
+    return setFindSlot(set, mixHash(hashObject(key)), key) >= 0;
 }
 
 void setRemoveElement(runtimeSet* set, Value key) {
-    dictRemoveElement(set->dict, key);
+    if (SET_IS_BITSET(set)) {
+        uint32_t n;
+        if (setBitsetKey(key, &n) && n / 64 < set->bitWords && ((set->bits[n / 64] >> (n % 64)) & 1)) {
+            set->bits[n / 64] &= ~((uint64_t) 1 << (n % 64));
+            set->numEntries--;
+            return;
+        }
+        raiseExceptionByName("ParameterError", "Key not found in set");
+        return;
+    }
+    int64_t i = setFindSlot(set, mixHash(hashObject(key)), key);
+    if (i < 0) {
+        raiseExceptionByName("ParameterError", "Key not found in set");
+        return;
+    }
+    uint32_t groupStart = (uint32_t) i & ~(DICT_GROUP_WIDTH - 1);
+    if (groupMatchEmpty(loadGroup(set->ctrl + groupStart)) != 0) {
+        set->ctrl[i] = DICT_CTRL_EMPTY;
+    } else {
+        set->ctrl[i] = DICT_CTRL_DELETED;
+        set->numDeleted++;
+    }
+    set->numEntries--;
+}
+
+bool setIterateNext(runtimeSet* set, uint32_t* cursor, Value* key) {
+    // Cursor is a bit index in bitset mode and a slot index otherwise
+    if (SET_IS_BITSET(set)) {
+        uint32_t bitCount = set->bitWords * 64;
+        while (*cursor < bitCount) {
+            uint32_t n = (*cursor)++;
+            if ((set->bits[n / 64] >> (n % 64)) & 1) {
+                *key = NUMBER_VAL(n);
+                return true;
+            }
+        }
+        return false;
+    }
+    while (*cursor < set->tableSize) {
+        uint32_t i = (*cursor)++;
+        if (SET_SLOT_IS_FULL(set, i)) {
+            *key = set->entries[i].key;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Adds every element of src to an empty set dst
+static void setCopyInto(runtimeSet* dst, runtimeSet* src) {
+    if (SET_IS_BITSET(src)) {
+        if (src->bitWords > 0) {
+            setGrowBits(dst, src->bitWords);
+            memcpy(dst->bits, src->bits, sizeof(uint64_t) * src->bitWords);
+        }
+    } else {
+        initSetTable(dst, src->tableSize);
+        memcpy(dst->ctrl, src->ctrl, src->tableSize);
+        memcpy(dst->entries, src->entries, sizeof(runtimeSetEntry) * src->tableSize);
+        dst->numDeleted = src->numDeleted;
+    }
+    dst->numEntries = src->numEntries;
+}
+
+static inline uint32_t bitsetCount(uint64_t* bits, uint32_t words) {
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < words; w++) count += (uint32_t) __builtin_popcountll(bits[w]);
+    return count;
+}
+
+// Set operations fill an empty result set without re-hashing elements that already carry a hash
+
+void setUnion(runtimeSet* result, runtimeSet* a, runtimeSet* b) {
+    if (SET_IS_BITSET(a) && SET_IS_BITSET(b)) {
+        runtimeSet* larger = a->bitWords >= b->bitWords ? a : b;
+        runtimeSet* smaller = larger == a ? b : a;
+        setCopyInto(result, larger);
+        for (uint32_t w = 0; w < smaller->bitWords; w++) result->bits[w] |= smaller->bits[w];
+        result->numEntries = bitsetCount(result->bits, result->bitWords);
+        return;
+    }
+    // Copy the hashed side, then add the other
+    if (SET_IS_BITSET(a)) {
+        runtimeSet* temp = a;
+        a = b;
+        b = temp;
+    }
+    setCopyInto(result, a);
+    if (SET_IS_BITSET(b)) {
+        for (uint32_t w = 0; w < b->bitWords; w++) {
+            for (uint64_t word = b->bits[w]; word != 0; word &= word - 1) {
+                uint32_t n = w * 64 + (uint32_t) __builtin_ctzll(word);
+                Value key = NUMBER_VAL(n);
+                uint32_t hash = setBitsetHash(n);
+                if (setFindSlot(result, hash, key) < 0) setInsertNew(result, key, hash);
+            }
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < b->tableSize; i++) {
+        if (!SET_SLOT_IS_FULL(b, i)) continue;
+        runtimeSetEntry* entry = &b->entries[i];
+        if (setFindSlot(result, entry->hash, entry->key) < 0) setInsertNew(result, entry->key, entry->hash);
+    }
+}
+
+void setIntersection(runtimeSet* result, runtimeSet* a, runtimeSet* b) {
+    if (SET_IS_BITSET(a) && SET_IS_BITSET(b)) {
+        runtimeSet* smaller = a->bitWords <= b->bitWords ? a : b;
+        runtimeSet* larger = smaller == a ? b : a;
+        setCopyInto(result, smaller);
+        for (uint32_t w = 0; w < result->bitWords; w++) result->bits[w] &= larger->bits[w];
+        result->numEntries = bitsetCount(result->bits, result->bitWords);
+        return;
+    }
+    // Walk the smaller set and probe the other
+    if (a->numEntries > b->numEntries) {
+        runtimeSet* temp = a;
+        a = b;
+        b = temp;
+    }
+    if (!SET_IS_BITSET(a) && !SET_IS_BITSET(b)) {
+        // Both hashed, reuse stored hashes
+        initSetTable(result, dictTableSizeFor(a->numEntries + a->numEntries / 4 + 1));
+        for (uint32_t i = 0; i < a->tableSize; i++) {
+            if (!SET_SLOT_IS_FULL(a, i)) continue;
+            runtimeSetEntry* entry = &a->entries[i];
+            if (setFindSlot(b, entry->hash, entry->key) >= 0) setInsertNew(result, entry->key, entry->hash);
+        }
+        return;
+    }
+    uint32_t cursor = 0;
+    Value key;
+    while (setIterateNext(a, &cursor, &key)) {
+        if (setContainsElement(b, key)) setInsertElement(result, key);
+    }
+}
+
+void setDifference(runtimeSet* result, runtimeSet* a, runtimeSet* b) {
+    if (SET_IS_BITSET(a) && SET_IS_BITSET(b)) {
+        setCopyInto(result, a);
+        uint32_t words = a->bitWords < b->bitWords ? a->bitWords : b->bitWords;
+        for (uint32_t w = 0; w < words; w++) result->bits[w] &= ~b->bits[w];
+        result->numEntries = bitsetCount(result->bits, result->bitWords);
+        return;
+    }
+    if (SET_IS_BITSET(a) || SET_IS_BITSET(b)) {
+        uint32_t cursor = 0;
+        Value key;
+        while (setIterateNext(a, &cursor, &key)) {
+            if (!setContainsElement(b, key)) setInsertElement(result, key);
+        }
+        return;
+    }
+    // Both hashed, reuse stored hashes
+    initSetTable(result, dictTableSizeFor(a->numEntries + a->numEntries / 4 + 1));
+    for (uint32_t i = 0; i < a->tableSize; i++) {
+        if (!SET_SLOT_IS_FULL(a, i)) continue;
+        runtimeSetEntry* entry = &a->entries[i];
+        if (setFindSlot(b, entry->hash, entry->key) < 0) setInsertNew(result, entry->key, entry->hash);
+    }
 }
 
 void freeRuntimeSet(runtimeSet* set) {
-    freeRuntimeDict(set->dict);
-    free(set);
+    slabFree(set->ctrl, set->tableSize);
+    slabFree(set->entries, sizeof(runtimeSetEntry) * set->tableSize);
+    slabFree(set->bits, sizeof(uint64_t) * set->bitWords);
+    slabFree(set, sizeof(runtimeSet));
 }
 
 void printRuntimeSet(runtimeSet* set) {
-    runtimeDict* dict = set->dict;
     bool first = true;
+    uint32_t cursor = 0;
+    Value key;
     printf("s{");
-    for (uint32_t i = 0; i < dict->tableSize; i++) {
-        runtimeDictEntry* entry = dict->entries[i];
-        while (entry) {
-            if (first) {
-                first = false;
-            } else {
-                printf(", ");
-            }
-            DSPrintValue(entry->key);
-
-            entry = entry->next;
+    while (setIterateNext(set, &cursor, &key)) {
+        if (first) {
+            first = false;
+        } else {
+            printf(", ");
         }
+        DSPrintValue(key);
     }
     printf("}");
 }
@@ -334,20 +1257,16 @@ void printRuntimeSet(runtimeSet* set) {
 void printRuntimeDict(runtimeDict* dict) {
     bool first = true;
     printf("d{");
-    for (uint32_t i = 0; i < dict->tableSize; i++) {
-        runtimeDictEntry* entry = dict->entries[i];
-        while (entry) {
-            if (first) {
-                first = false;
-            } else {
-                printf(", ");
-            }
-            DSPrintValue(entry->key);
-            printf(":");
-            DSPrintValue(entry->value);
-
-            entry = entry->next;
+    for (uint32_t i = 0; i < dict->entryCount; i++) {
+        if (!DICT_ENTRY_IS_LIVE(&dict->entries[i])) continue;
+        if (first) {
+            first = false;
+        } else {
+            printf(", ");
         }
+        DSPrintValue(dict->entries[i].key);
+        printf(":");
+        DSPrintValue(dict->entries[i].value);
     }
     printf("}");
 }
@@ -357,7 +1276,7 @@ void DSPrintValue(Value val) {
         printf("NULL");
         return;
     }
-    Value printFunc = ignoreNullGetAttr(val, "print");
+    Value printFunc = ignoreNullGetAttr(val, SYMBOL_PRINT);
     if (!IS_INTERNAL_NULL(printFunc)) {
         execInput(printFunc, val, NULL, 0);
     } else if (VALUE_TYPE(val) == BUILTIN_CALLABLE) {
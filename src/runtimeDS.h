@@ -18,19 +18,60 @@ struct runtimeList {
 typedef struct runtimeDictEntry runtimeDictEntry;
 
 struct runtimeDictEntry {
-    Value key;
+    Value key; // INTERNAL_NULL once removed
     Value value;
-    runtimeDictEntry* next;
+    uint32_t hash; // Mixed hash of key, reused on resize
 };
 
+#define DICT_CTRL_EMPTY 0x80
+#define DICT_CTRL_DELETED 0xFE
+// Full slots hold the low 7 bits of the hash in their control byte
+#define DICT_SLOT_IS_FULL(dict, i) ((dict)->ctrl[i] < 0x80)
+#define DICT_ENTRY_IS_LIVE(entry) (!IS_INTERNAL_NULL((entry)->key))
+
+// Compact dict, entries are kept in insertion order in a dense array and found through
+// an open addressing index table whose control bytes are probed a group at a time
 struct runtimeDict {
-    uint32_t tableSize;
-    uint32_t numEntries;
-    runtimeDictEntry** entries;
+    uint32_t tableSize; // Index slots, power of two, at least one group
+    uint32_t numEntries; // Live entries
+    uint32_t numDeleted; // Deleted index slots
+    uint32_t entryCount; // Used entries including removed ones
+    uint32_t entryCapacity;
+    uint8_t* ctrl;
+    uint32_t* indices; // Entry index of each full slot
+    runtimeDictEntry* entries;
+};
+
+typedef struct runtimeSetEntry runtimeSetEntry;
+
+struct runtimeSetEntry {
+    Value key;
+    uint32_t hash; // Mixed hash of key, reused on resize
 };
 
+#define SET_IS_BITSET(set) ((set)->ctrl == NULL)
+#define SET_SLOT_IS_FULL(set, i) ((set)->ctrl[i] < 0x80)
+
+// Key only open addressing table probed like runtimeDict. Sets holding only small
+// non-negative integers are stored as a bitset until any other element is added.
 struct runtimeSet {
-    runtimeDict* dict;
+    uint32_t tableSize; // Power of two, 0 in bitset mode
+    uint32_t numEntries;
+    uint32_t numDeleted;
+    uint8_t* ctrl; // NULL in bitset mode
+    runtimeSetEntry* entries;
+    uint64_t* bits; // Bitset mode only, bit n is set if n is an element
+    uint32_t bitWords;
+};
+
+// Unboxed numeric array, floatArray stores doubles and intArray stores int64_t
+struct runtimeArray {
+    union {
+        double* floats;
+        int64_t* ints;
+    };
+    uint32_t size;
+    uint32_t capacity;
 };
 
 // List functions
@@ -43,23 +84,52 @@ void listRemoveElement(runtimeList* list, uint32_t index);
 Value listGetElement(runtimeList* list, uint32_t index);
 bool listContainsElement(runtimeList* list, Value value);
 uint32_t listIndexOfElement(runtimeList* list, Value value);
+void listExtend(runtimeList* list, runtimeList* other);
+void listReverse(runtimeList* list);
+void listSlice(runtimeList* result, runtimeList* list, uint32_t start, uint32_t end);
+void listSort(runtimeList* list, runtimeList* keys);
 
 // Dict functions
 runtimeDict* createRuntimeDict(uint32_t size);
 void dictInsertElement(runtimeDict* dict, Value key, Value value);
 Value dictGetElement(runtimeDict* dict, Value key);
+Value* dictGetValueRef(runtimeDict* dict, Value key);
 bool dictContainsElement(runtimeDict* dict, Value key);
 void dictRemoveElement(runtimeDict* dict, Value key);
+bool dictIterateNext(runtimeDict* dict, uint32_t* cursor, Value* key);
 
 // Dict additional functions
 Value dictStrGet(runtimeDict* dict, char* key);
 Value dictNumGet(runtimeDict* dict, double key);
 
 // Set functions
-runtimeSet* createRuntimeSet(uint32_t size);
+runtimeSet* createRuntimeSet();
 void setInsertElement(runtimeSet* set, Value key);
 bool setContainsElement(runtimeSet* set, Value key);
 void setRemoveElement(runtimeSet* set, Value key);
+bool setIterateNext(runtimeSet* set, uint32_t* cursor, Value* key);
+
+// Set operations, result must be an empty set
+void setUnion(runtimeSet* result, runtimeSet* a, runtimeSet* b);
+void setIntersection(runtimeSet* result, runtimeSet* a, runtimeSet* b);
+void setDifference(runtimeSet* result, runtimeSet* a, runtimeSet* b);
+
+// Array functions
+runtimeArray* createRuntimeArray(uint32_t size);
+void arrayResize(runtimeArray* array, uint32_t size);
+void arrayAddElement(runtimeArray* array, bool isInt, double value);
+void arraySetElement(runtimeArray* array, bool isInt, uint32_t index, double value);
+Value arrayGetElement(runtimeArray* array, bool isInt, uint32_t index);
+double arraySum(runtimeArray* array, bool isInt);
+double arrayDot(runtimeArray* x, runtimeArray* y, bool isInt);
+double arrayMin(runtimeArray* array, bool isInt);
+double arrayMax(runtimeArray* array, bool isInt);
+void arrayScale(runtimeArray* array, bool isInt, double factor);
+void arrayAddScalar(runtimeArray* array, bool isInt, double value);
+void arrayAdd(runtimeArray* result, runtimeArray* x, runtimeArray* y, bool isInt);
+void arrayMul(runtimeArray* result, runtimeArray* x, runtimeArray* y, bool isInt);
+void arrayCopy(runtimeArray* dst, runtimeArray* src);
+void arraySort(runtimeArray* array, bool isInt);
 
 // General Purpose Functions
 uint32_t hashObject(Value key);
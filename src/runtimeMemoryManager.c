@@ -2,68 +2,310 @@
 // Created by congyu on 8/20/23.
 //
 
+// mmap flags, fork and sched_yield are hidden by -std=c11
+#define _DEFAULT_SOURCE
+
 #include "runtimeMemoryManager.h"
 #include "errors.h"
 #include "vm.h"
+#include "objShape.h"
+
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#ifdef GC_CONCURRENT_MARK
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
-uint32_t blockIDCounter;
+#ifdef GC_PARALLEL_THREADS
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 PriorityQueue* blockQueue;
 
-runtimeDict* rtBlockDict;
+// Blocks indexed by blockID, IDs of freed blocks are reused
+RuntimeBlock** blockTable;
+uint32_t blockTableSize;
+uint32_t blockTableCapacity;
+uint32_t* freeBlockIDs;
+uint32_t freeBlockIDCount;
+uint32_t blockCount;
+
+// Arenas blocks are carved from, and freed blocks waiting for reuse
+char** arenas;
+uint32_t arenaCount;
+uint32_t arenaCapacity;
+char* arenaCursor;
+char* arenaEnd;
+RuntimeBlock** freeArenaBlocks;
+uint32_t freeArenaBlockCount;
+uint32_t freeArenaBlockCapacity;
+
+// Blocks holding young objects, swept by minor collections
+RuntimeBlock** nurseryBlocks;
+uint32_t nurseryBlockCount;
+uint32_t nurseryBlockCapacity;
+
+// Old generation
+uint32_t oldCount;
+uint32_t majorThreshold;
+
+// Young generation, objects allocated since the last collection
+uint32_t youngCount;
+
+// Old objects written to since the last collection
+Object** rememberedSet;
+uint32_t rememberedCount;
+uint32_t rememberedCapacity;
+
+// Minor collections do not mark or trace old objects
+bool minorCollection;
+
+// Incremental major collection
+gcPhaseType gcPhase;
+uint32_t allocationsSinceStep;
+
+// Marked objects whose children are not traced yet
+Object** grayStack;
+uint32_t grayCount;
+uint32_t grayCapacity;
+
+// Blocks whose sweepEpoch differs are not swept yet in the current major collection
+uint32_t sweepEpoch;
+uint32_t sweepCursor;
+
+#ifdef GC_CONCURRENT_MARK
+// Marker process and the dead objects it reports, GC_BITMAP_WORDS words per blockID
+pid_t markerPid;
+uint64_t* markerDeadBits;
+size_t markerDeadBitsSize;
+uint32_t markerBlockCount;
+#endif
+
+#ifdef GC_PARALLEL_THREADS
+// Worker of a parallel collection, worker 0 is the interpreter thread
+typedef struct gcWorker {
+    pthread_t thread;
+    // Private gray stack, only touched by its worker
+    Object** grayStack;
+    uint32_t grayCount;
+    uint32_t grayCapacity;
+    // Gray objects handed out to idle workers
+    pthread_mutex_t sharedLock;
+    Object** sharedStack;
+    uint32_t sharedCount;
+    uint32_t sharedCapacity;
+    // Objects freed in the worker's blocks
+    uint32_t removedCount;
+    // Objects freed in the worker's blocks, their payloads are released by the interpreter thread
+    // as neither the string table nor the slab allocator is thread safe
+    Object** deadObjects;
+    uint32_t deadObjectCount;
+    uint32_t deadObjectCapacity;
+} gcWorker;
+
+typedef enum gcParallelTask {
+    GC_TASK_MARK,
+    GC_TASK_SWEEP
+} gcParallelTask;
+
+gcWorker gcWorkers[GC_PARALLEL_THREADS];
+_Thread_local gcWorker* currentWorker;
+bool parallelMarking;
+bool parallelSweeping;
+uint32_t idleWorkers;
 
-Object* rtHead;
+// Worker pool, protected by poolLock
+pthread_mutex_t poolLock;
+pthread_cond_t poolCond;
+pthread_cond_t poolDoneCond;
+uint64_t poolGeneration;
+uint32_t poolPending;
+gcParallelTask poolTask;
+bool poolShutdown;
+#endif
 
 // Block Operations
 
+static inline void finalizeObject(Object* obj) {
+#ifdef GC_PARALLEL_THREADS
+    // Dead slots keep their contents until the next allocation, which only happens after the sweep
+    if (parallelSweeping) {
+        gcWorker* worker = currentWorker;
+        if (worker->deadObjectCount == worker->deadObjectCapacity) {
+            worker->deadObjectCapacity = worker->deadObjectCapacity == 0 ? 64 : worker->deadObjectCapacity * 2;
+            worker->deadObjects = (Object**) realloc(worker->deadObjects, sizeof(Object*) * worker->deadObjectCapacity);
+            if (worker->deadObjects == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for dead objects.");
+        }
+        worker->deadObjects[worker->deadObjectCount++] = obj;
+        return;
+    }
+#endif
+    freeObjectPayload(obj);
+}
+
+static inline RuntimeBlock* blockOf(Object* obj) {
+    return (RuntimeBlock*) ((uintptr_t) obj & ~(uintptr_t) (RUNTIME_BLOCK_BYTES - 1));
+}
+
+static inline void newArena() {
+    // Map twice the size to cut out an arena aligned to its own size
+    size_t mappedSize = (size_t) GC_ARENA_SIZE * 2;
+    char* mapped = mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        raiseExceptionByName("ObjManagerError", "Memory allocation failed for new arena.");
+        return;
+    }
+    char* arena = (char*) (((uintptr_t) mapped + GC_ARENA_SIZE - 1) & ~(uintptr_t) (GC_ARENA_SIZE - 1));
+    if (arena > mapped) munmap(mapped, (size_t) (arena - mapped));
+    if (arena + GC_ARENA_SIZE < mapped + mappedSize) munmap(arena + GC_ARENA_SIZE, (size_t) (mapped + mappedSize - arena - GC_ARENA_SIZE));
+#ifdef GC_ARENA_HUGE_PAGES
+    madvise(arena, GC_ARENA_SIZE, MADV_HUGEPAGE);
+#endif
+    if (arenaCount == arenaCapacity) {
+        arenaCapacity = arenaCapacity == 0 ? 4 : arenaCapacity * 2;
+        arenas = (char**) realloc(arenas, sizeof(char*) * arenaCapacity);
+        if (arenas == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for arena list.");
+    }
+    arenas[arenaCount++] = arena;
+    arenaCursor = arena;
+    arenaEnd = arena + GC_ARENA_SIZE;
+}
+
+static inline RuntimeBlock* allocateArenaBlock() {
+    if (freeArenaBlockCount > 0) return freeArenaBlocks[--freeArenaBlockCount];
+    if (arenaCursor == arenaEnd) newArena();
+    RuntimeBlock* block = (RuntimeBlock*) arenaCursor;
+    arenaCursor += RUNTIME_BLOCK_BYTES;
+    return block;
+}
+
+static inline void releaseArenaBlock(RuntimeBlock* block) {
+    if (freeArenaBlockCount == freeArenaBlockCapacity) {
+        freeArenaBlockCapacity = freeArenaBlockCapacity == 0 ? 16 : freeArenaBlockCapacity * 2;
+        freeArenaBlocks = (RuntimeBlock**) realloc(freeArenaBlocks, sizeof(RuntimeBlock*) * freeArenaBlockCapacity);
+        if (freeArenaBlocks == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for free block list.");
+    }
+#ifndef GC_ARENA_HUGE_PAGES
+    // Return the pages to the system but keep the address range, huge pages would be split
+    madvise(block, RUNTIME_BLOCK_BYTES, MADV_DONTNEED);
+#endif
+    freeArenaBlocks[freeArenaBlockCount++] = block;
+}
+
+static inline void registerBlock(RuntimeBlock* block) {
+    if (freeBlockIDCount > 0) {
+        block->blockID = freeBlockIDs[--freeBlockIDCount];
+    } else {
+        if (blockTableSize == blockTableCapacity) {
+            blockTableCapacity *= 2;
+            blockTable = (RuntimeBlock**) realloc(blockTable, sizeof(RuntimeBlock*) * blockTableCapacity);
+            freeBlockIDs = (uint32_t*) realloc(freeBlockIDs, sizeof(uint32_t) * blockTableCapacity);
+            if (blockTable == NULL || freeBlockIDs == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for block table.");
+        }
+        block->blockID = blockTableSize++;
+    }
+    blockTable[block->blockID] = block;
+    blockCount++;
+}
+
 static inline RuntimeBlock* newBlock() {
 #ifdef PRINT_MEMORY_INFO
     printf("Allocating new block\n");
 #endif
-    RuntimeBlock* newBlock = (RuntimeBlock*) malloc(sizeof(RuntimeBlock));
-    if (newBlock == NULL) raiseExceptionByName("ObjManagerError", "Memory allocation failed for new block");
+    RuntimeBlock* newBlock = allocateArenaBlock();
 
     // Set block ID
-    newBlock->blockID = blockIDCounter++;
-    // Add block to runtime block dictionary
-    dictInsertElement(rtBlockDict, NUMBER_VAL(newBlock->blockID), PTR_VAL(newBlock));
+    registerBlock(newBlock);
 
     // Set revived flag
     newBlock->revived = false;
+    newBlock->inNursery = false;
+    // New blocks hold nothing to sweep in a running major collection
+    newBlock->sweepEpoch = sweepEpoch;
 
-    // Insert new free slots onto free stack
-    Object** stackTop = newBlock->freeStack;
-    Object* newSlot = (Object*) newBlock->block;
-    for (int i = 0; i < RUNTIME_BLOCK_SIZE; i++) {
-        // Set object's block id to the new block
-        newSlot->blockID = newBlock->blockID;
-        *stackTop++ = newSlot++;
-    }
-
-    // Update free stack top
-    newBlock->freeStackTop = stackTop;
+    // All slots are free
+    memset(newBlock->allocBits, 0, sizeof(newBlock->allocBits));
+    memset(newBlock->youngBits, 0, sizeof(newBlock->youngBits));
+    memset(newBlock->markBits, 0, sizeof(newBlock->markBits));
     // Set occupied slots
     newBlock->availableSlots = RUNTIME_BLOCK_SIZE;
     return newBlock;
 }
 
+static inline void freeBlock(RuntimeBlock* block) {
+    blockTable[block->blockID] = NULL;
+    freeBlockIDs[freeBlockIDCount++] = block->blockID;
+    blockCount--;
+    releaseArenaBlock(block);
+}
+
+static inline void addNurseryBlock(RuntimeBlock* block) {
+    if (nurseryBlockCount == nurseryBlockCapacity) {
+        nurseryBlockCapacity *= 2;
+        nurseryBlocks = (RuntimeBlock**) realloc(nurseryBlocks, sizeof(RuntimeBlock*) * nurseryBlockCapacity);
+        if (nurseryBlocks == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for nursery blocks.");
+    }
+    block->inNursery = true;
+    nurseryBlocks[nurseryBlockCount++] = block;
+}
+
 static inline Object* allocateFromBlock(RuntimeBlock* block) {
     if (block->availableSlots == 0) {
         raiseExceptionByName("ObjManagerError", "Allocating from full block.");
     }
-    block->availableSlots--;
-    return *--block->freeStackTop;
+    for (uint32_t i = 0; i < GC_BITMAP_WORDS; i++) {
+        uint64_t freeBits = ~block->allocBits[i];
+        if (freeBits == 0) continue;
+        uint64_t slotBit = freeBits & -freeBits;
+        block->allocBits[i] |= slotBit;
+        block->youngBits[i] |= slotBit;
+        block->availableSlots--;
+        if (!block->inNursery) addNurseryBlock(block);
+        return &block->block[i * 64 + __builtin_ctzll(slotBit)];
+    }
+    raiseExceptionByName("ObjManagerError", "Block bitmap has no free slot.");
+    return NULL;
 }
 
-static inline void deallocateFromBlock(RuntimeBlock* block, Object* slot) {
-    if (block->availableSlots == RUNTIME_BLOCK_SIZE) {
-        raiseExceptionByName("ObjManagerError", "Deallocating from empty block.");
-    } else if (block->availableSlots == 0) {
+// Finalizes the objects in deadBits of one bitmap word and returns their slots to the block
+static inline void freeSlots(RuntimeBlock* block, uint32_t word, uint64_t deadBits) {
+    for (uint64_t bits = deadBits; bits != 0; bits &= bits - 1) {
+        Object* deadObj = &block->block[word * 64 + __builtin_ctzll(bits)];
+#ifdef PRINT_GC_REMOVAL
+        printf("Removed Object: ");
+        printObject(deadObj);
+        printf("\n");
+#endif
+        finalizeObject(deadObj);
+    }
+    if (block->availableSlots == 0) {
         // Set revived flag
         block->revived = true;
     }
-    *block->freeStackTop++ = slot;
-    block->availableSlots++;
+    block->allocBits[word] &= ~deadBits;
+    block->availableSlots += (uint32_t) __builtin_popcountll(deadBits);
+}
+
+// Sets the object's mark bit, returns whether it was set already
+static inline bool testAndMark(Object* obj) {
+    RuntimeBlock* block = blockOf(obj);
+    uint32_t index = (uint32_t) (obj - block->block);
+    uint64_t slotBit = 1ULL << (index % 64);
+    uint64_t* markWord = &block->markBits[index / 64];
+    if (*markWord & slotBit) return true;
+    *markWord |= slotBit;
+    return false;
+}
+
+static inline bool isMarked(Object* obj) {
+    RuntimeBlock* block = blockOf(obj);
+    uint32_t index = (uint32_t) (obj - block->block);
+    return (block->markBits[index / 64] >> (index % 64)) & 1;
 }
 
 // Priority Queue Operations
@@ -75,16 +317,13 @@ void printManagementDS() {
         printf("Block #%u: %u", blockQueue->data[i]->blockID, blockQueue->data[i]->availableSlots);
     }
     printf("]\n");
-    printf("RT Block Dict: \n[");
+    printf("Block Table: \n[");
     uint32_t count = 0;
-    for (uint32_t i=0; i < rtBlockDict->tableSize; i++) {
-        runtimeDictEntry* entry = rtBlockDict->entries[i];
-        while (entry) {
-            RuntimeBlock* currBlock = (RuntimeBlock*) VALUE_PTR_VAL(entry->value);
-            if (count++ > 0) printf(", ");
-            printf("Block #%u: %u", currBlock->blockID, currBlock->availableSlots);
-            entry = entry->next;
-        }
+    for (uint32_t i=0; i < blockTableSize; i++) {
+        RuntimeBlock* currBlock = blockTable[i];
+        if (currBlock == NULL) continue;
+        if (count++ > 0) printf(", ");
+        printf("Block #%u: %u", currBlock->blockID, currBlock->availableSlots);
     }
     printf("]\n");
 }
@@ -158,7 +397,7 @@ void pqAddBlock(RuntimeBlock* block) {
 }
 
 static inline void reHeapify() {
-    for (uint32_t i = (blockQueue->size / 2) - 1; i >= 0; i--) heapifyDown(i);
+    for (int64_t i = (int64_t) (blockQueue->size / 2) - 1; i >= 0; i--) heapifyDown((uint32_t) i);
 }
 
 void updateBlock(uint32_t blockID, uint32_t newAvailableSlots) {
@@ -196,43 +435,120 @@ static inline RuntimeBlock* getTopBlock(PriorityQueue* pq) {
     return pq->data[0];
 }
 
+
+
+
 // Memory Manager Operations
 
+#ifdef GC_PARALLEL_THREADS
+static void initWorkerPool();
+static void freeWorkerPool();
+#endif
+
 void initMemoryManager() {
     // Init priority queue
     initPriorityQueue();
-    // Set block ID counter
-    blockIDCounter = 0;
-    // Initialize runtime block dictionary
-    rtBlockDict = createRuntimeDict(RUNTIME_DICT_INIT_SIZE);
+    // Init block table
+    blockTable = (RuntimeBlock**) malloc(sizeof(RuntimeBlock*) * BLOCK_TABLE_INIT_SIZE);
+    freeBlockIDs = (uint32_t*) malloc(sizeof(uint32_t) * BLOCK_TABLE_INIT_SIZE);
+    if (blockTable == NULL || freeBlockIDs == NULL) raiseExceptionByName("ObjManagerError", "Memory allocation failed for block table.");
+    blockTableSize = 0;
+    blockTableCapacity = BLOCK_TABLE_INIT_SIZE;
+    freeBlockIDCount = 0;
+    blockCount = 0;
+    // Init arenas, the first block maps the first arena
+    arenas = NULL;
+    arenaCount = 0;
+    arenaCapacity = 0;
+    arenaCursor = NULL;
+    arenaEnd = NULL;
+    freeArenaBlocks = NULL;
+    freeArenaBlockCount = 0;
+    freeArenaBlockCapacity = 0;
+    // Init nursery block list
+    nurseryBlockCapacity = GC_NURSERY_SIZE / RUNTIME_BLOCK_SIZE + 1;
+    nurseryBlocks = (RuntimeBlock**) malloc(sizeof(RuntimeBlock*) * nurseryBlockCapacity);
+    if (nurseryBlocks == NULL) raiseExceptionByName("ObjManagerError", "Memory allocation failed for nursery blocks.");
+    nurseryBlockCount = 0;
+    sweepEpoch = 0;
+    sweepCursor = 0;
     // Create initial block & Insert initial block into priority queue
     pqAddBlock(newBlock());
-    // Init runtime head
-    rtHead = NULL;
+    // Init generations
+    oldCount = 0;
+    majorThreshold = GC_MAJOR_MIN_THRESHOLD;
+    youngCount = 0;
+    // Init remembered set
+    rememberedSet = (Object**) malloc(sizeof(Object*) * REMEMBERED_SET_INIT_SIZE);
+    if (rememberedSet == NULL) raiseExceptionByName("ObjManagerError", "Memory allocation failed for remembered set.");
+    rememberedCount = 0;
+    rememberedCapacity = REMEMBERED_SET_INIT_SIZE;
+    minorCollection = false;
+    // Init incremental collection
+    gcPhase = GC_PHASE_IDLE;
+    allocationsSinceStep = 0;
+    grayStack = (Object**) malloc(sizeof(Object*) * GRAY_STACK_INIT_SIZE);
+    if (grayStack == NULL) raiseExceptionByName("ObjManagerError", "Memory allocation failed for gray stack.");
+    grayCount = 0;
+    grayCapacity = GRAY_STACK_INIT_SIZE;
+#ifdef GC_CONCURRENT_MARK
+    markerPid = -1;
+    markerDeadBits = NULL;
+    markerDeadBitsSize = 0;
+    markerBlockCount = 0;
+#endif
+#ifdef GC_PARALLEL_THREADS
+    initWorkerPool();
+#endif
 }
 
 void freeMemoryManager() {
+#ifdef GC_PARALLEL_THREADS
+    freeWorkerPool();
+#endif
+#ifdef GC_CONCURRENT_MARK
+    // Stop a marker process that is still running
+    if (markerPid > 0) {
+        kill(markerPid, SIGKILL);
+        waitpid(markerPid, NULL, 0);
+    }
+    if (markerDeadBits != NULL) munmap(markerDeadBits, markerDeadBitsSize);
+#endif
     // Free priority queue
     freePriorityQueue();
-    for (uint32_t i=0; i < rtBlockDict->tableSize; i++) {
-        runtimeDictEntry* entry = rtBlockDict->entries[i];
-        while (entry) {
-            RuntimeBlock* currBlock = (RuntimeBlock*) VALUE_PTR_VAL(entry->value);
-            free(currBlock);
-            entry = entry->next;
-        }
+    // Free arenas and block table
+    for (uint32_t i=0; i < arenaCount; i++) munmap(arenas[i], GC_ARENA_SIZE);
+    free(arenas);
+    free(freeArenaBlocks);
+    free(blockTable);
+    free(freeBlockIDs);
+    free(nurseryBlocks);
+    // Free remembered set
+    free(rememberedSet);
+    // Free gray stack
+    free(grayStack);
+}
+
+void rememberObject(Object* obj) {
+    if (rememberedCount == rememberedCapacity) {
+        rememberedCapacity *= 2;
+        rememberedSet = (Object**) realloc(rememberedSet, sizeof(Object*) * rememberedCapacity);
+        if (rememberedSet == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for remembered set.");
     }
-    // Free runtime block dictionary
-    freeRuntimeDict(rtBlockDict);
+    obj->remembered = true;
+    rememberedSet[rememberedCount++] = obj;
 }
 
 // Forward declaration
 static inline void collectGarbage();
+static inline void incrementalStep();
 
 Object* newObjectSlot() {
-    // First, check is priority queue is empty
-    if (blockQueue->size == 0) collectGarbage();
-    // If priority queue is still empty, allocate new block
+    // Advance a running major collection proportionally to allocation
+    if (gcPhase != GC_PHASE_IDLE && ++allocationsSinceStep >= GC_INCREMENTAL_STEP_SIZE) incrementalStep();
+    // Collect once the nursery is full
+    if (youngCount >= GC_NURSERY_SIZE) collectGarbage();
+    // If priority queue is empty, allocate new block
     if (blockQueue->size == 0) pqAddBlock(newBlock());
     // Get top block
     RuntimeBlock* topBlock = getTopBlock(blockQueue);
@@ -246,105 +562,142 @@ Object* newObjectSlot() {
         // Remove the block from priority queue
         pqRemoveBlock(topBlock->blockID);
     }
-    newSlot->next = rtHead;
-    rtHead = newSlot;
+    // New objects start in the young generation
+    newSlot->isOld = false;
+    newSlot->remembered = false;
+    youngCount++;
     return newSlot;
 }
 
 // Print function
 void printRTLL() {
-    Object* currObj = rtHead;
-    while (currObj != NULL) {
-        printObject(currObj);
-        printf("\n");
-        currObj = currObj->next;
+    for (uint32_t i=0; i < blockTableSize; i++) {
+        RuntimeBlock* currBlock = blockTable[i];
+        if (currBlock == NULL) continue;
+        for (uint32_t j=0; j < GC_BITMAP_WORDS; j++) {
+            for (uint64_t bits = currBlock->allocBits[j]; bits != 0; bits &= bits - 1) {
+                printObject(&currBlock->block[j * 64 + __builtin_ctzll(bits)]);
+                printf("\n");
+            }
+        }
     }
 }
 
 // Forward declaration
 static inline void iterateValue(Value val);
 
+static inline void pushGray(Object* obj) {
+    if (grayCount == grayCapacity) {
+        grayCapacity *= 2;
+        grayStack = (Object**) realloc(grayStack, sizeof(Object*) * grayCapacity);
+        if (grayStack == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for gray stack.");
+    }
+    grayStack[grayCount++] = obj;
+}
+
+// Pops the top gray object and prefetches the header of the next one
+static inline Object* popGray() {
+    Object* obj = grayStack[--grayCount];
+    if (grayCount > 0) __builtin_prefetch(grayStack[grayCount - 1]);
+    return obj;
+}
+
+// Fetches an object header ahead of markValue reading it
+static inline void prefetchValue(Value val) {
+    if (IS_MARKABLE_VAL(val)) __builtin_prefetch(VALUE_OBJ_VAL(val));
+}
+
+#ifdef GC_PARALLEL_THREADS
+static inline void pushWorkerGray(gcWorker* worker, Object* obj) {
+    if (worker->grayCount == worker->grayCapacity) {
+        worker->grayCapacity *= 2;
+        worker->grayStack = (Object**) realloc(worker->grayStack, sizeof(Object*) * worker->grayCapacity);
+        if (worker->grayStack == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for gray stack.");
+    }
+    worker->grayStack[worker->grayCount++] = obj;
+}
+
+static inline bool atomicTestAndMark(Object* obj) {
+    RuntimeBlock* block = blockOf(obj);
+    uint32_t index = (uint32_t) (obj - block->block);
+    uint64_t slotBit = 1ULL << (index % 64);
+    return (__atomic_fetch_or(&block->markBits[index / 64], slotBit, __ATOMIC_RELAXED) & slotBit) != 0;
+}
+#endif
+
+static inline void markValue(Value val) {
+    if (!IS_MARKABLE_VAL(val)) return;
+    Object* currObj = VALUE_OBJ_VAL(val);
+    if (currObj->isConst || (minorCollection && currObj->isOld)) return;
+#ifdef GC_PARALLEL_THREADS
+    if (parallelMarking) {
+        // Workers race for the mark bit, the winner traces the object
+        if (atomicTestAndMark(currObj)) return;
+        if (IS_ITERABLE_VAL(val)) pushWorkerGray(currentWorker, currObj);
+        return;
+    }
+#endif
+    if (testAndMark(currObj)) return;
+    // Children are traced from the gray stack, never by recursion on the C stack
+    if (IS_ITERABLE_VAL(val)) pushGray(currObj);
+}
+
+void markBarrier(Object* owner, Object* obj) {
+    if (owner->isConst || obj->isConst || !isMarked(owner)) return;
+    markValue(OBJECT_VAL(obj, obj->type));
+}
 void iterateList(Value val) {
     runtimeList* list = VALUE_LIST_VALUE(val);
+    // Not initialized yet
+    if (list == NULL) return;
     Value* currValPtr = list->list;
-    for (int i=0; i<list->size; i++) {
-        Value currVal = *currValPtr;
-        if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-            Object* currObj = VALUE_OBJ_VAL(currVal);
-            if (!(currObj->isConst || currObj->marked)) {
-                currObj->marked = true;
-                if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-            }
-        }
-        currValPtr++;
+    for (uint32_t i=0; i<list->size; i++) {
+        if (i + GC_PREFETCH_DISTANCE < list->size) prefetchValue(currValPtr[GC_PREFETCH_DISTANCE]);
+        markValue(*currValPtr++);
     }
 }
 
 void iterateDict(Value val) {
     runtimeDict* dict = VALUE_DICT_VALUE(val);
-    for (uint32_t i=0; i < dict->tableSize; i++) {
-        runtimeDictEntry* entry = dict->entries[i];
-        while (entry) {
-            Value currVal = entry->key;
-            if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-                Object* currObj = VALUE_OBJ_VAL(currVal);
-                if (!(currObj->isConst || currObj->marked)) {
-                    currObj->marked = true;
-                    if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-                }
-            }
-            currVal = entry->value;
-            if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-                Object* currObj = VALUE_OBJ_VAL(currVal);
-                if (!(currObj->isConst || currObj->marked)) {
-                    currObj->marked = true;
-                    if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-                }
-            }
-            entry = entry->next;
-        }
+    if (dict == NULL) return;
+    for (uint32_t i=0; i < dict->entryCount; i++) {
+        runtimeDictEntry* entry = &dict->entries[i];
+        if (!DICT_ENTRY_IS_LIVE(entry)) continue;
+        markValue(entry->key);
+        markValue(entry->value);
     }
 }
 
 void iterateSet(Value val) {
     runtimeSet* set = VALUE_SET_VALUE(val);
-    runtimeDict* dict = set->dict;
-    for (uint32_t i=0; i < dict->tableSize; i++) {
-        runtimeDictEntry* entry = dict->entries[i];
-        while (entry) {
-            Value currVal = entry->key;
-            if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-                Object* currObj = VALUE_OBJ_VAL(currVal);
-                if (!(currObj->isConst || currObj->marked)) {
-                    currObj->marked = true;
-                    if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-                }
-            }
-            entry = entry->next;
-        }
+    // Bitsets only hold numbers
+    if (set == NULL || SET_IS_BITSET(set)) return;
+    for (uint32_t i=0; i < set->tableSize; i++) {
+        if (SET_SLOT_IS_FULL(set, i)) markValue(set->entries[i].key);
     }
 }
 
-void iterateStrObjHashTable(strValueHash* table) {
-    for (uint32_t i=0; i < table->table_size; i++) {
-        strValueEntry* entry = table->entries[i];
-        while (entry != NULL) {
-            Value currVal = entry->value;
-            if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-                Object* currObj = VALUE_OBJ_VAL(currVal);
-                if (!(currObj->isConst || currObj->marked)) {
-                    currObj->marked = true;
-                    if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-                }
-            }
-            entry = entry->next;
-        }
+void iterateSymValTable(symValueTable* table) {
+    for (uint32_t i=0; i < table->tableSize; i++) {
+        symValueEntry* entry = &table->entries[i];
+        if (entry->symbol != SYMBOL_NONE) markValue(entry->value);
     }
 }
 
+void iterateObjAttrs(objAttrs* attrs) {
+    if (OBJ_ATTRS_IS_DICT_MODE(attrs)) {
+        iterateSymValTable(attrs->dictAttrs);
+        return;
+    }
+    Value* currValPtr = attrs->slots;
+    uint32_t slotCount = attrs->shape->slotCount;
+    for (uint32_t i=0; i < slotCount; i++) prefetchValue(currValPtr[i]);
+    for (uint32_t i=0; i < slotCount; i++) markValue(*currValPtr++);
+}
+
 static inline void iterateValue(Value val) {
     if (!IS_SYSTEM_DEFINED_TYPE(val.type)) {
-        iterateStrObjHashTable(VALUE_ATTRS(val));
+        iterateObjAttrs(VALUE_ATTRS(val));
         return;
     }
     // Runtime data structure attributes
@@ -358,157 +711,538 @@ static inline void iterateValue(Value val) {
         case BUILTIN_SET:
             iterateSet(val);
             break;
+        case BUILTIN_FLOAT_ARRAY:
+        case BUILTIN_INT_ARRAY:
+            // Unboxed numbers hold no references
+            break;
         default:
             raiseExceptionByName("GCError", "Invalid value type for iteration");
     }
 }
 
-static inline void markObject() {
+static inline void markRoots() {
     VM* currVM = vm;
     // Iterate stack
-    Value* currStackPtr = currVM->stack;
-    Value currVal = *currStackPtr;
-    while (currStackPtr != currVM->stackTop) {
-        if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-            Object* currObj = VALUE_OBJ_VAL(currVal);
-            if (!(currObj->isConst || currObj->marked)) {
-                currObj->marked = true;
-                if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-            }
-        }
-        currVal = *currStackPtr++;
-    }
+    for (Value* currStackPtr = currVM->stack; currStackPtr != currVM->stackTop; currStackPtr++) markValue(*currStackPtr);
     // Iterate global ref array
-    currStackPtr = currVM->globalRefArray;
-    currVal = *currStackPtr;
-    for (int i=0; i<vm->globalRefCount; i++) {
-        if (!IS_INTERNAL_NULL(currVal) && IS_MARKABLE_VAL(currVal)) {
-            Object* currObj = VALUE_OBJ_VAL(currVal);
-            if (!(currObj->isConst || currObj->marked)) {
-                currObj->marked = true;
-                if (IS_ITERABLE_VAL(currVal)) iterateValue(currVal);
-            }
-        }
-        currVal = *currStackPtr++;
+    for (uint32_t i=0; i<currVM->globalRefCount; i++) markValue(currVM->globalRefArray[i]);
+}
+
+// Old objects stored into since the last collection may hold the only reference to a young object
+static inline void markRememberedSet() {
+    for (uint32_t i=0; i<rememberedCount; i++) {
+        Object* currObj = rememberedSet[i];
+        iterateValue(OBJECT_VAL(currObj, currObj->type));
     }
 }
 
-static inline uint32_t sweepObject() {
+static inline void clearRememberedSet() {
+    for (uint32_t i=0; i<rememberedCount; i++) rememberedSet[i]->remembered = false;
+    rememberedCount = 0;
+}
+
+
+// Sweeps the nursery blocks, survivors are promoted to the old generation in place
+static inline uint32_t sweepYoung() {
     uint32_t removedCount = 0;
-#ifdef PRINT_GC_REMOVAL
-    uint32_t totalCount = 0;
-#endif
-
-    Object* currObj = rtHead;
-    Object* prevObj = NULL;
-    while (currObj != NULL) {
-        if (currObj->marked) { // Marked object
-            // Unmark object
-            currObj->marked = false;
-            // Move to next object
-            prevObj = currObj;
-            currObj = currObj->next;
-        } else { // Unmarked object
-#ifdef PRINT_GC_REMOVAL
-            printf("Removed Object [%u]: ", totalCount);
-            printObject(currObj);
-            printf("\n");
-#endif
-            removedCount++;
-            // LL delete
-            if (prevObj == NULL) {
-                rtHead = currObj->next;
-            } else {
-                prevObj->next = currObj->next;
+    for (uint32_t i=0; i < nurseryBlockCount; i++) {
+        RuntimeBlock* block = nurseryBlocks[i];
+        block->inNursery = false;
+        // A running major collection still needs the marks of survivors, unless their block is swept already
+        bool keepMarks = gcPhase == GC_PHASE_MARK || (gcPhase == GC_PHASE_SWEEP && block->sweepEpoch != sweepEpoch);
+        for (uint32_t j=0; j < GC_BITMAP_WORDS; j++) {
+            uint64_t youngBits = block->youngBits[j];
+            if (youngBits == 0) continue;
+            uint64_t survivorBits = youngBits & block->markBits[j];
+            for (uint64_t bits = survivorBits; bits != 0; bits &= bits - 1) {
+                Object* currObj = &block->block[j * 64 + __builtin_ctzll(bits)];
+                currObj->isOld = true;
+                // Survivors promoted while a major collection is marking get traced later
+                if (gcPhase == GC_PHASE_MARK && IS_ITERABLE_VAL(OBJECT_VAL(currObj, currObj->type))) pushGray(currObj);
             }
-            Object* nextObj = currObj->next;
-
-            // Find block in which object is allocated
-            RuntimeBlock* block = (RuntimeBlock*) VALUE_PTR_VAL(dictGetElement(rtBlockDict, NUMBER_VAL(currObj->blockID)));
-            // Deallocate object
-            deallocateFromBlock(block, currObj);
-            currObj = nextObj;
+            oldCount += (uint32_t) __builtin_popcountll(survivorBits);
+            if (!keepMarks) block->markBits[j] &= ~survivorBits;
+            uint64_t deadBits = youngBits & ~survivorBits;
+            if (deadBits != 0) {
+                removedCount += (uint32_t) __builtin_popcountll(deadBits);
+                freeSlots(block, j, deadBits);
+            }
+            block->youngBits[j] = 0;
         }
-#ifdef PRINT_GC_REMOVAL
-        totalCount++;
-#endif
     }
-#ifdef PRINT_GC_INFO
-    printf("GC removed %u objects\n", removedCount);
-#endif
+    nurseryBlockCount = 0;
+    youngCount = 0;
     return removedCount;
 }
 
+// Frees the unmarked old objects of a block and clears its marks, returns the number of slots examined
+static inline uint32_t sweepBlock(RuntimeBlock* block) {
+    uint32_t examinedCount = 1;
+    block->sweepEpoch = sweepEpoch;
+    for (uint32_t i=0; i < GC_BITMAP_WORDS; i++) {
+        uint64_t oldBits = block->allocBits[i] & ~block->youngBits[i];
+        uint64_t deadBits = oldBits & ~block->markBits[i];
+#ifdef GC_CONCURRENT_MARK
+        // Dead objects of a snapshot come from the marker process
+        if (markerDeadBits != NULL) deadBits = block->blockID < markerBlockCount ? markerDeadBits[block->blockID * GC_BITMAP_WORDS + i] : 0;
+#endif
+        block->markBits[i] = 0;
+        examinedCount += (uint32_t) __builtin_popcountll(oldBits);
+        if (deadBits != 0) {
+            oldCount -= (uint32_t) __builtin_popcountll(deadBits);
+            freeSlots(block, i, deadBits);
+        }
+    }
+    return examinedCount;
+}
+
 static inline uint32_t determineFreeCount(uint32_t totalBlockCount, uint32_t freeBlockCount) {
-    // Heuristic to determine number of blocks to free
-    return freeBlockCount - MAX_ALLOWED_EMPTY_BLOCK;
+    // Keep enough empty blocks for the next nursery
+    uint32_t keepCount = GC_NURSERY_SIZE / RUNTIME_BLOCK_SIZE + MAX_ALLOWED_EMPTY_BLOCK;
+    return freeBlockCount > keepCount ? freeBlockCount - keepCount : 0;
 }
 
 static inline void freeUnusedBlocks() {
-    // Create runtime list to store empty blocks
-    runtimeList* emptyList = createRuntimeList(RUNTIME_LIST_INIT_SIZE);
-
-    // Iterate to find empty blocks
-    for (uint32_t i=0; i < rtBlockDict->tableSize; i++) {
-        runtimeDictEntry* entry = rtBlockDict->entries[i];
-        while (entry) {
-            RuntimeBlock* currBlock = (RuntimeBlock*) VALUE_PTR_VAL(entry->value);
-            if (currBlock->availableSlots == RUNTIME_BLOCK_SIZE) {
-                // Add to empty list
-                listAddElement(emptyList, PTR_VAL(currBlock));
-            }
-            entry = entry->next;
-        }
+    // Count empty blocks, blocks emptied by a sweep wait to be revived first
+    uint32_t emptyCount = 0;
+    for (uint32_t i=0; i < blockTableSize; i++) {
+        RuntimeBlock* currBlock = blockTable[i];
+        if (currBlock != NULL && currBlock->availableSlots == RUNTIME_BLOCK_SIZE && !currBlock->revived) emptyCount++;
     }
 
     // Determine number of blocks to free
-    uint32_t targetFreeCount = determineFreeCount(rtBlockDict->numEntries, emptyList->size);
-
-    if (targetFreeCount > 0) {
-        // Free blocks
-        // Iterate list to find empty blocks
-        uint32_t freedCount = 0;
-
-        Value* listValueArray = emptyList->list;
-        for (uint32_t i=0; i < emptyList->size; i++) {
-            RuntimeBlock* currBlock = (RuntimeBlock*) VALUE_PTR_VAL(listValueArray[i]);
-            // Free block
-            free(currBlock);
-            freedCount++;
-            if (freedCount >= targetFreeCount) break;
-        }
-    }
+    uint32_t targetFreeCount = determineFreeCount(blockCount, emptyCount);
 
-    // Free runtime list
-    freeRuntimeList(emptyList);
+    // Empty blocks that are not revived are always in the priority queue
+    for (uint32_t i=0; i < blockTableSize && targetFreeCount > 0; i++) {
+        RuntimeBlock* currBlock = blockTable[i];
+        if (currBlock == NULL || currBlock->availableSlots != RUNTIME_BLOCK_SIZE || currBlock->revived) continue;
+        pqRemoveBlock(currBlock->blockID);
+        freeBlock(currBlock);
+        targetFreeCount--;
+    }
 }
 
 static inline void reviveBlocks() {
     // Reorder block queue
     reHeapify();
     // Iterate to find possibly revived blocks
-    for (uint32_t i=0; i < rtBlockDict->tableSize; i++) {
-        runtimeDictEntry* entry = rtBlockDict->entries[i];
-        while (entry) {
-            RuntimeBlock* currBlock = (RuntimeBlock*) VALUE_PTR_VAL(entry->value);
-            if (currBlock->revived) {
-                // Reset flag
-                currBlock->revived = false;
-                // Insert into heap
-                pqAddBlock(currBlock);
+    for (uint32_t i=0; i < blockTableSize; i++) {
+        RuntimeBlock* currBlock = blockTable[i];
+        if (currBlock != NULL && currBlock->revived) {
+            // Reset flag
+            currBlock->revived = false;
+            // Insert into heap
+            pqAddBlock(currBlock);
+        }
+    }
+}
+
+static inline void drainGrayStack(uint32_t bottom);
+
+// Young objects marked by a running major collection may have gained unmarked children since,
+// stores into young owners take no barrier. Minor collections and the final remark trace them again,
+// survivors of a minor collection are pushed gray again when promoted.
+static inline void resetYoungMarks() {
+    for (uint32_t i=0; i < nurseryBlockCount; i++) {
+        RuntimeBlock* block = nurseryBlocks[i];
+        for (uint32_t j=0; j < GC_BITMAP_WORDS; j++) block->markBits[j] &= ~block->youngBits[j];
+    }
+    uint32_t oldGrayCount = 0;
+    for (uint32_t i=0; i < grayCount; i++) {
+        if (grayStack[i]->isOld) grayStack[oldGrayCount++] = grayStack[i];
+    }
+    grayCount = oldGrayCount;
+}
+
+// Traces young objects from the roots and the remembered set
+static inline uint32_t minorCollect() {
+    if (gcPhase == GC_PHASE_MARK) resetYoungMarks();
+    // Gray objects of a running major collection stay below grayBottom
+    uint32_t grayBottom = grayCount;
+    minorCollection = true;
+    markRoots();
+    markRememberedSet();
+    drainGrayStack(grayBottom);
+    minorCollection = false;
+    clearRememberedSet();
+    uint32_t removedCount = sweepYoung();
+#ifdef PRINT_GC_INFO
+    printf("Minor GC removed %u objects, %u old objects\n", removedCount, oldCount);
+#endif
+    return removedCount;
+}
+
+#ifdef GC_CONCURRENT_MARK
+// Runs in the forked marker process. Its copy of the heap is frozen at the fork,
+// so marking it needs no barrier and an object unmarked in the snapshot stays unreachable.
+static void runConcurrentMarker() {
+    gcPhase = GC_PHASE_MARK;
+    markRoots();
+    drainGrayStack(0);
+    for (uint32_t i=0; i < markerBlockCount; i++) {
+        RuntimeBlock* currBlock = blockTable[i];
+        if (currBlock == NULL) continue;
+        for (uint32_t j=0; j < GC_BITMAP_WORDS; j++) {
+            markerDeadBits[i * GC_BITMAP_WORDS + j] = currBlock->allocBits[j] & ~currBlock->youngBits[j] & ~currBlock->markBits[j];
+        }
+    }
+    // Skip atexit handlers and stdio buffers shared with the interpreter
+    _exit(0);
+}
+
+// Returns false if no marker process could be started
+static inline bool startConcurrentMark() {
+    markerBlockCount = blockTableSize;
+    markerDeadBitsSize = sizeof(uint64_t) * GC_BITMAP_WORDS * (markerBlockCount + 1);
+    markerDeadBits = mmap(NULL, markerDeadBitsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (markerDeadBits == MAP_FAILED) {
+        markerDeadBits = NULL;
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid == 0) runConcurrentMarker();
+    if (pid < 0) {
+        munmap(markerDeadBits, markerDeadBitsSize);
+        markerDeadBits = NULL;
+        return false;
+    }
+    markerPid = pid;
+    gcPhase = GC_PHASE_CONCURRENT_MARK;
+    // Blocks created from now on hold nothing of the snapshot
+    sweepEpoch++;
+    sweepCursor = 0;
+    allocationsSinceStep = 0;
+#ifdef PRINT_GC_INFO
+    printf("Major GC started marker process, %u old objects\n", oldCount);
+#endif
+    return true;
+}
+
+// Starts sweeping once the marker process has exited
+static inline void pollConcurrentMark() {
+    int status;
+    pid_t result = waitpid(markerPid, &status, WNOHANG);
+    if (result == 0) return;
+    markerPid = -1;
+    // Keep every object if the marker did not finish
+    if (result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) memset(markerDeadBits, 0, markerDeadBitsSize);
+    gcPhase = GC_PHASE_SWEEP;
+#ifdef PRINT_GC_INFO
+    printf("Major GC marker process finished\n");
+#endif
+}
+#endif
+
+#ifdef GC_PARALLEL_THREADS
+// Moves the upper half of the private gray stack to the shared stack, if that is empty
+static inline void shareWork(gcWorker* worker) {
+    pthread_mutex_lock(&worker->sharedLock);
+    if (worker->sharedCount == 0) {
+        uint32_t moveCount = worker->grayCount / 2;
+        if (moveCount > worker->sharedCapacity) {
+            worker->sharedCapacity = moveCount;
+            worker->sharedStack = (Object**) realloc(worker->sharedStack, sizeof(Object*) * worker->sharedCapacity);
+            if (worker->sharedStack == NULL) raiseExceptionByName("ObjManagerError", "Memory reallocation failed for gray stack.");
+        }
+        worker->grayCount -= moveCount;
+        memcpy(worker->sharedStack, worker->grayStack + worker->grayCount, sizeof(Object*) * moveCount);
+        __atomic_store_n(&worker->sharedCount, moveCount, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&worker->sharedLock);
+}
+
+// Takes a shared stack, starting with the worker's own
+static inline bool stealWork(gcWorker* worker) {
+    uint32_t workerIndex = (uint32_t) (worker - gcWorkers);
+    for (uint32_t i = 0; i < GC_PARALLEL_THREADS; i++) {
+        gcWorker* victim = &gcWorkers[(workerIndex + i) % GC_PARALLEL_THREADS];
+        if (__atomic_load_n(&victim->sharedCount, __ATOMIC_RELAXED) == 0) continue;
+        pthread_mutex_lock(&victim->sharedLock);
+        uint32_t stolenCount = victim->sharedCount;
+        for (uint32_t j = 0; j < stolenCount; j++) pushWorkerGray(worker, victim->sharedStack[j]);
+        __atomic_store_n(&victim->sharedCount, 0, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&victim->sharedLock);
+        if (stolenCount > 0) return true;
+    }
+    return false;
+}
+
+static inline bool hasSharedWork() {
+    for (uint32_t i = 0; i < GC_PARALLEL_THREADS; i++) {
+        if (__atomic_load_n(&gcWorkers[i].sharedCount, __ATOMIC_RELAXED) > 0) return true;
+    }
+    return false;
+}
+
+static void parallelMark(gcWorker* worker) {
+    while (true) {
+        while (worker->grayCount > 0) {
+            Object* currObj = worker->grayStack[--worker->grayCount];
+            if (worker->grayCount > 0) __builtin_prefetch(worker->grayStack[worker->grayCount - 1]);
+            iterateValue(OBJECT_VAL(currObj, currObj->type));
+            if (worker->grayCount >= GC_PARALLEL_SHARE_THRESHOLD && __atomic_load_n(&worker->sharedCount, __ATOMIC_RELAXED) == 0) shareWork(worker);
+        }
+        if (stealWork(worker)) continue;
+        // Only idle workers remain once every worker is idle, nobody can share work any more
+        __atomic_add_fetch(&idleWorkers, 1, __ATOMIC_SEQ_CST);
+        while (true) {
+            if (__atomic_load_n(&idleWorkers, __ATOMIC_SEQ_CST) == GC_PARALLEL_THREADS) return;
+            if (hasSharedWork()) {
+                __atomic_sub_fetch(&idleWorkers, 1, __ATOMIC_SEQ_CST);
+                break;
             }
-            entry = entry->next;
+            sched_yield();
+        }
+    }
+}
+
+// Sweeps the worker's range of the block table, a block's bitmaps are only touched by one worker
+static void parallelSweep(gcWorker* worker) {
+    uint32_t workerIndex = (uint32_t) (worker - gcWorkers);
+    uint32_t start = (uint32_t) ((uint64_t) blockTableSize * workerIndex / GC_PARALLEL_THREADS);
+    uint32_t end = (uint32_t) ((uint64_t) blockTableSize * (workerIndex + 1) / GC_PARALLEL_THREADS);
+    worker->removedCount = 0;
+    for (uint32_t i = start; i < end; i++) {
+        RuntimeBlock* block = blockTable[i];
+        if (block == NULL) continue;
+        for (uint32_t j = 0; j < GC_BITMAP_WORDS; j++) {
+            uint64_t deadBits = block->allocBits[j] & ~block->markBits[j];
+            block->markBits[j] = 0;
+            if (deadBits == 0) continue;
+            worker->removedCount += (uint32_t) __builtin_popcountll(deadBits);
+            freeSlots(block, j, deadBits);
+        }
+    }
+}
+
+static void runWorkerTask(gcWorker* worker, gcParallelTask task) {
+    currentWorker = worker;
+    if (task == GC_TASK_MARK) {
+        parallelMark(worker);
+    } else {
+        parallelSweep(worker);
+    }
+}
+
+static void* workerMain(void* arg) {
+    gcWorker* worker = (gcWorker*) arg;
+    uint64_t seenGeneration = 0;
+    pthread_mutex_lock(&poolLock);
+    while (true) {
+        while (poolGeneration == seenGeneration && !poolShutdown) pthread_cond_wait(&poolCond, &poolLock);
+        if (poolShutdown) break;
+        seenGeneration = poolGeneration;
+        gcParallelTask task = poolTask;
+        pthread_mutex_unlock(&poolLock);
+        runWorkerTask(worker, task);
+        pthread_mutex_lock(&poolLock);
+        if (--poolPending == 0) pthread_cond_signal(&poolDoneCond);
+    }
+    pthread_mutex_unlock(&poolLock);
+    return NULL;
+}
+
+// Runs a task on every worker, the interpreter thread acts as worker 0
+static void runParallelTask(gcParallelTask task) {
+    pthread_mutex_lock(&poolLock);
+    poolTask = task;
+    poolPending = GC_PARALLEL_THREADS - 1;
+    poolGeneration++;
+    pthread_cond_broadcast(&poolCond);
+    pthread_mutex_unlock(&poolLock);
+    runWorkerTask(&gcWorkers[0], task);
+    pthread_mutex_lock(&poolLock);
+    while (poolPending > 0) pthread_cond_wait(&poolDoneCond, &poolLock);
+    pthread_mutex_unlock(&poolLock);
+}
+
+static void initWorkerPool() {
+    pthread_mutex_init(&poolLock, NULL);
+    pthread_cond_init(&poolCond, NULL);
+    pthread_cond_init(&poolDoneCond, NULL);
+    poolGeneration = 0;
+    poolPending = 0;
+    poolShutdown = false;
+    parallelMarking = false;
+    parallelSweeping = false;
+    for (uint32_t i = 0; i < GC_PARALLEL_THREADS; i++) {
+        gcWorker* worker = &gcWorkers[i];
+        worker->grayStack = (Object**) malloc(sizeof(Object*) * GRAY_STACK_INIT_SIZE);
+        if (worker->grayStack == NULL) raiseExceptionByName("ObjManagerError", "Memory allocation failed for gray stack.");
+        worker->grayCount = 0;
+        worker->grayCapacity = GRAY_STACK_INIT_SIZE;
+        pthread_mutex_init(&worker->sharedLock, NULL);
+        worker->sharedStack = NULL;
+        worker->sharedCount = 0;
+        worker->sharedCapacity = 0;
+        worker->deadObjects = NULL;
+        worker->deadObjectCount = 0;
+        worker->deadObjectCapacity = 0;
+        if (i > 0 && pthread_create(&worker->thread, NULL, workerMain, worker) != 0) {
+            raiseExceptionByName("ObjManagerError", "Failed to start garbage collector worker.");
+        }
+    }
+}
+
+static void freeWorkerPool() {
+    pthread_mutex_lock(&poolLock);
+    poolShutdown = true;
+    pthread_cond_broadcast(&poolCond);
+    pthread_mutex_unlock(&poolLock);
+    for (uint32_t i = 0; i < GC_PARALLEL_THREADS; i++) {
+        gcWorker* worker = &gcWorkers[i];
+        if (i > 0) pthread_join(worker->thread, NULL);
+        free(worker->grayStack);
+        free(worker->sharedStack);
+        free(worker->deadObjects);
+        pthread_mutex_destroy(&worker->sharedLock);
+    }
+    pthread_cond_destroy(&poolDoneCond);
+    pthread_cond_destroy(&poolCond);
+    pthread_mutex_destroy(&poolLock);
+}
+
+// Stop-the-world major collection on all workers, runs right after a minor collection so every object is old
+static inline void parallelMajorCollect() {
+    // Shade the roots and deal them out round robin
+    parallelMarking = true;
+    currentWorker = &gcWorkers[0];
+    markRoots();
+    uint32_t rootCount = gcWorkers[0].grayCount;
+    gcWorkers[0].grayCount = 0;
+    for (uint32_t i = 0; i < rootCount; i++) pushWorkerGray(&gcWorkers[i % GC_PARALLEL_THREADS], gcWorkers[0].grayStack[i]);
+    idleWorkers = 0;
+    runParallelTask(GC_TASK_MARK);
+    parallelMarking = false;
+    parallelSweeping = true;
+    runParallelTask(GC_TASK_SWEEP);
+    parallelSweeping = false;
+    uint32_t removedCount = 0;
+    for (uint32_t i = 0; i < GC_PARALLEL_THREADS; i++) {
+        gcWorker* worker = &gcWorkers[i];
+        removedCount += worker->removedCount;
+        for (uint32_t j = 0; j < worker->deadObjectCount; j++) freeObjectPayload(worker->deadObjects[j]);
+        worker->deadObjectCount = 0;
+    }
+    oldCount -= removedCount;
+    clearRememberedSet();
+    // Grow the heap proportionally to what survived
+    majorThreshold = oldCount * GC_MAJOR_GROWTH_FACTOR;
+    if (majorThreshold < GC_MAJOR_MIN_THRESHOLD) majorThreshold = GC_MAJOR_MIN_THRESHOLD;
+    if (removedCount > 0) reviveBlocks();
+    freeUnusedBlocks();
+#ifdef PRINT_GC_INFO
+    printf("Parallel major GC removed %u objects, %u old objects\n", removedCount, oldCount);
+#endif
+}
+#endif
+
+// Starts a major collection right after a minor collection, so the roots only reference old objects
+static inline void startMajorCycle() {
+#if defined(GC_PARALLEL_THREADS)
+    parallelMajorCollect();
+    return;
+#elif defined(GC_CONCURRENT_MARK)
+    if (startConcurrentMark()) return;
+#endif
+    gcPhase = GC_PHASE_MARK;
+    allocationsSinceStep = 0;
+    markRoots();
+#ifdef PRINT_GC_INFO
+    printf("Major GC started, %u old objects\n", oldCount);
+#endif
+}
+
+static inline void drainGrayStack(uint32_t bottom) {
+    while (grayCount > bottom) {
+        Object* currObj = popGray();
+        iterateValue(OBJECT_VAL(currObj, currObj->type));
+    }
+}
+
+// Atomic end of marking, roots and remembered objects are not covered by the barrier and are rescanned
+static inline void finishMarking() {
+    resetYoungMarks();
+    markRoots();
+    markRememberedSet();
+    drainGrayStack(0);
+    // Every block now has to be swept, blocks created from now on hold nothing to sweep
+    gcPhase = GC_PHASE_SWEEP;
+    sweepEpoch++;
+    sweepCursor = 0;
+    // Young objects were traced again by the remark
+    clearRememberedSet();
+    uint32_t removedCount = sweepYoung();
+    if (removedCount > 0) reviveBlocks();
+#ifdef PRINT_GC_INFO
+    printf("Major GC marked, removed %u young objects\n", removedCount);
+#endif
+}
+
+static inline void finishSweeping() {
+    gcPhase = GC_PHASE_IDLE;
+#ifdef GC_CONCURRENT_MARK
+    if (markerDeadBits != NULL) {
+        munmap(markerDeadBits, markerDeadBitsSize);
+        markerDeadBits = NULL;
+    }
+#endif
+    // Grow the heap proportionally to what survived
+    majorThreshold = oldCount * GC_MAJOR_GROWTH_FACTOR;
+    if (majorThreshold < GC_MAJOR_MIN_THRESHOLD) majorThreshold = GC_MAJOR_MIN_THRESHOLD;
+    // Blocks filled up during the cycle may have been freed into
+    reviveBlocks();
+    freeUnusedBlocks();
+#ifdef PRINT_GC_INFO
+    printf("Major GC finished, %u old objects\n", oldCount);
+#endif
+}
+
+static inline bool pauseExceeded(uint32_t work, uint32_t* nextClockCheck, clock_t start) {
+    // Always make progress, then only check the clock now and then
+    if (work < GC_INCREMENTAL_STEP_SIZE || work < *nextClockCheck) return false;
+    *nextClockCheck = work + 64;
+    return (uint64_t) (clock() - start) * 1000000 >= (uint64_t) GC_MAX_PAUSE_US * CLOCKS_PER_SEC;
+}
+
+// Traces or sweeps a slice of the heap, proportional to the allocations since the last slice
+static inline void incrementalStep() {
+    uint32_t workTarget = allocationsSinceStep * GC_INCREMENTAL_WORK_RATIO;
+    allocationsSinceStep = 0;
+    clock_t start = clock();
+    uint32_t work = 0;
+    uint32_t nextClockCheck = 0;
+#ifdef GC_CONCURRENT_MARK
+    if (gcPhase == GC_PHASE_CONCURRENT_MARK) pollConcurrentMark();
+#endif
+    while (gcPhase == GC_PHASE_MARK && work < workTarget && !pauseExceeded(work, &nextClockCheck, start)) {
+        if (grayCount == 0) {
+            finishMarking();
+            break;
+        }
+        Object* currObj = popGray();
+        iterateValue(OBJECT_VAL(currObj, currObj->type));
+        work++;
+    }
+    while (gcPhase == GC_PHASE_SWEEP && work < workTarget && !pauseExceeded(work, &nextClockCheck, start)) {
+        if (sweepCursor == blockTableSize) {
+            finishSweeping();
+            break;
         }
+        RuntimeBlock* currBlock = blockTable[sweepCursor++];
+        if (currBlock == NULL || currBlock->sweepEpoch == sweepEpoch) continue;
+        work += sweepBlock(currBlock);
     }
 }
 
 static inline void collectGarbage() {
-    // Mark and sweep
-    markObject();
-    // Sweep
-    if (sweepObject() > 0) reviveBlocks();
+    uint32_t removedCount = minorCollect();
+    if (removedCount > 0) reviveBlocks();
     // Free unused blocks
     freeUnusedBlocks();
+    // Old generation outgrew its threshold
+    if (gcPhase == GC_PHASE_IDLE && oldCount >= majorThreshold) startMajorCycle();
 #ifdef PRINT_BLOCK_ORDER
     printf("GC Cleaned\n");
     printManagementDS();
@@ -10,24 +10,70 @@
 
 typedef struct RuntimeBlock RuntimeBlock;
 
+#define GC_BITMAP_WORDS (RUNTIME_BLOCK_SIZE / 64)
+#if RUNTIME_BLOCK_SIZE % 64 != 0
+#error "RUNTIME_BLOCK_SIZE must be a multiple of 64"
+#endif
+#if GC_ARENA_SIZE % RUNTIME_BLOCK_BYTES != 0
+#error "GC_ARENA_SIZE must be a multiple of RUNTIME_BLOCK_BYTES"
+#endif
+
+// Bit i of each bitmap describes block[i]. Blocks are RUNTIME_BLOCK_BYTES aligned,
+// so the block of an object is found by masking its address.
 struct RuntimeBlock {
     Object block[RUNTIME_BLOCK_SIZE];
-    Object* freeStack[RUNTIME_BLOCK_SIZE];
-    Object** freeStackTop;
+    uint64_t allocBits[GC_BITMAP_WORDS];
+    uint64_t youngBits[GC_BITMAP_WORDS];
+    uint64_t markBits[GC_BITMAP_WORDS];
     uint32_t availableSlots;
-    uint16_t blockID;
+    uint32_t blockID;
+    // Equal to the global sweepEpoch once swept in the current major collection
+    uint32_t sweepEpoch;
+    // Listed in the nursery blocks swept by minor collections
+    bool inNursery;
     bool revived;
 };
 
+_Static_assert(sizeof(RuntimeBlock) <= RUNTIME_BLOCK_BYTES, "RuntimeBlock does not fit into RUNTIME_BLOCK_BYTES");
+
 typedef struct PriorityQueue {
     RuntimeBlock** data;
     uint32_t size;
     uint32_t capacity;
 } PriorityQueue;
 
+// Progress of the incremental major collection
+typedef enum gcPhaseType {
+    GC_PHASE_IDLE,
+    GC_PHASE_MARK,
+    // A forked marker process marks a snapshot of the old generation, see GC_CONCURRENT_MARK
+    GC_PHASE_CONCURRENT_MARK,
+    GC_PHASE_SWEEP
+} gcPhaseType;
+
+extern gcPhaseType gcPhase;
+
 void initMemoryManager();
 void freeMemoryManager();
 
 Object* newObjectSlot();
+void rememberObject(Object* obj);
+void markBarrier(Object* owner, Object* obj);
+
+// Call after storing val into owner. Old objects that may now reference young
+// objects are remembered so minor collections can trace them without scanning the old generation.
+// While a major collection is marking, old values stored into marked owners are shaded
+// so no marked object points to an unmarked one (Dijkstra barrier).
+#define GC_WRITE_BARRIER(owner, val) \
+    do { \
+        if ((owner)->isOld && IS_MARKABLE_VAL(val)) { \
+            Object* barrierObj = VALUE_OBJ_VAL(val); \
+            if (!barrierObj->isOld) { \
+                if (!(owner)->remembered) rememberObject(owner); \
+            } else if (gcPhase == GC_PHASE_MARK) { \
+                markBarrier(owner, barrierObj); \
+            } \
+        } \
+    } while (0)
 
 #endif //CJ_2_RUNTIMEMEMORYMANAGER_H
@@ -0,0 +1,225 @@
+//
+// Created by congyu on 10/19/26.
+//
+
+#include "slabAllocator.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct slabPage slabPage;
+
+// Header at the start of every SLAB_PAGE_SIZE aligned page, the objects of one size class follow it
+struct slabPage {
+    // Pages of the class with free objects
+    slabPage* prev;
+    slabPage* next;
+    // All pages of the class
+    slabPage* allPrev;
+    slabPage* allNext;
+    // Freed objects, linked through their first word
+    void* freeList;
+    // Objects from bumpCursor onwards have never been handed out
+    char* bumpCursor;
+    char* end;
+    uint32_t liveCount;
+    uint32_t sizeClass;
+    bool inPartialList;
+};
+
+typedef struct slabClass {
+    slabPage* partialPages;
+    slabPage* allPages;
+    uint32_t pageCount;
+    uint32_t emptyPageCount;
+    size_t liveCount;
+} slabClass;
+
+static const uint32_t slabClassSizes[SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256, 320, 384, 448, 512,
+    640, 768, 896, 1024, 1280, 1536, 1792, 2048
+};
+
+#define SLAB_MAX_OBJECT_SIZE 2048
+#define SLAB_HEADER_SIZE ((sizeof(slabPage) + 15) & ~(size_t) 15)
+
+_Static_assert(SLAB_HEADER_SIZE + SLAB_MAX_OBJECT_SIZE <= SLAB_PAGE_SIZE, "SLAB_PAGE_SIZE is too small for the largest size class");
+
+static slabClass slabClasses[SLAB_CLASS_COUNT];
+// Bytes of allocations too large for a size class
+static size_t largeBytes;
+
+static inline uint32_t slabClassIndex(size_t size) {
+    // 16 byte steps up to 128, then four classes per power of two
+    if (size <= 128) return size == 0 ? 0 : (uint32_t) ((size - 1) >> 4);
+    uint32_t n = (uint32_t) size - 1;
+    uint32_t highBit = 31 - (uint32_t) __builtin_clz(n);
+    return 8 + (highBit - 7) * 4 + ((n >> (highBit - 2)) & 3);
+}
+
+static inline slabPage* pageOf(void* ptr) {
+    return (slabPage*) ((uintptr_t) ptr & ~(uintptr_t) (SLAB_PAGE_SIZE - 1));
+}
+
+static inline void linkPage(slabClass* currClass, slabPage* page) {
+    page->prev = NULL;
+    page->next = currClass->partialPages;
+    if (page->next != NULL) page->next->prev = page;
+    currClass->partialPages = page;
+    page->inPartialList = true;
+}
+
+static inline void unlinkPage(slabClass* currClass, slabPage* page) {
+    if (page->prev != NULL) {
+        page->prev->next = page->next;
+    } else {
+        currClass->partialPages = page->next;
+    }
+    if (page->next != NULL) page->next->prev = page->prev;
+    page->inPartialList = false;
+}
+
+static slabPage* newSlabPage(uint32_t sizeClass) {
+    slabPage* page = (slabPage*) aligned_alloc(SLAB_PAGE_SIZE, SLAB_PAGE_SIZE);
+    if (page == NULL) return NULL;
+    uint32_t objectSize = slabClassSizes[sizeClass];
+    page->freeList = NULL;
+    page->bumpCursor = (char*) page + SLAB_HEADER_SIZE;
+    page->end = page->bumpCursor + (SLAB_PAGE_SIZE - SLAB_HEADER_SIZE) / objectSize * objectSize;
+    page->liveCount = 0;
+    page->sizeClass = sizeClass;
+    slabClass* currClass = &slabClasses[sizeClass];
+    page->allPrev = NULL;
+    page->allNext = currClass->allPages;
+    if (page->allNext != NULL) page->allNext->allPrev = page;
+    currClass->allPages = page;
+    currClass->pageCount++;
+    currClass->emptyPageCount++;
+    linkPage(currClass, page);
+    return page;
+}
+
+static void freeSlabPage(slabClass* currClass, slabPage* page) {
+    if (page->inPartialList) unlinkPage(currClass, page);
+    if (page->allPrev != NULL) {
+        page->allPrev->allNext = page->allNext;
+    } else {
+        currClass->allPages = page->allNext;
+    }
+    if (page->allNext != NULL) page->allNext->allPrev = page->allPrev;
+    currClass->pageCount--;
+    free(page);
+}
+
+void* slabAlloc(size_t size) {
+    if (size > SLAB_MAX_OBJECT_SIZE) {
+        void* ptr = malloc(size);
+        if (ptr != NULL) largeBytes += size;
+        return ptr;
+    }
+    uint32_t sizeClass = slabClassIndex(size);
+    slabClass* currClass = &slabClasses[sizeClass];
+    slabPage* page = currClass->partialPages;
+    if (page == NULL) {
+        page = newSlabPage(sizeClass);
+        if (page == NULL) return NULL;
+    }
+    void* ptr;
+    if (page->freeList != NULL) {
+        ptr = page->freeList;
+        page->freeList = *(void**) ptr;
+    } else {
+        ptr = page->bumpCursor;
+        page->bumpCursor += slabClassSizes[sizeClass];
+    }
+    if (page->liveCount++ == 0) currClass->emptyPageCount--;
+    currClass->liveCount++;
+    // Full pages leave the partial list until an object is freed
+    if (page->freeList == NULL && page->bumpCursor == page->end) unlinkPage(currClass, page);
+    return ptr;
+}
+
+void* slabCalloc(size_t size) {
+    void* ptr = slabAlloc(size);
+    if (ptr != NULL) memset(ptr, 0, size);
+    return ptr;
+}
+
+void slabFree(void* ptr, size_t size) {
+    if (ptr == NULL) return;
+    if (size > SLAB_MAX_OBJECT_SIZE) {
+        largeBytes -= size;
+        free(ptr);
+        return;
+    }
+    slabPage* page = pageOf(ptr);
+    slabClass* currClass = &slabClasses[page->sizeClass];
+    *(void**) ptr = page->freeList;
+    page->freeList = ptr;
+    currClass->liveCount--;
+    if (!page->inPartialList) linkPage(currClass, page);
+    if (--page->liveCount > 0) return;
+    // Keep a few empty pages for the next allocations, return the rest
+    if (currClass->emptyPageCount >= SLAB_MAX_EMPTY_PAGES) {
+        freeSlabPage(currClass, page);
+    } else {
+        currClass->emptyPageCount++;
+    }
+}
+
+void* slabRealloc(void* ptr, size_t oldSize, size_t newSize) {
+    if (ptr == NULL) return slabAlloc(newSize);
+    if (oldSize > SLAB_MAX_OBJECT_SIZE && newSize > SLAB_MAX_OBJECT_SIZE) {
+        void* newPtr = realloc(ptr, newSize);
+        if (newPtr != NULL) largeBytes = largeBytes - oldSize + newSize;
+        return newPtr;
+    }
+    // Same size class, the object already has room
+    if (oldSize <= SLAB_MAX_OBJECT_SIZE && newSize <= SLAB_MAX_OBJECT_SIZE && slabClassIndex(oldSize) == slabClassIndex(newSize)) return ptr;
+    void* newPtr = slabAlloc(newSize);
+    if (newPtr == NULL) return NULL;
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    slabFree(ptr, oldSize);
+    return newPtr;
+}
+
+size_t slabClassObjectSize(uint32_t sizeClass) {
+    return slabClassSizes[sizeClass];
+}
+
+size_t slabClassHeldBytes(uint32_t sizeClass) {
+    return (size_t) slabClasses[sizeClass].pageCount * SLAB_PAGE_SIZE;
+}
+
+size_t slabClassUsedBytes(uint32_t sizeClass) {
+    return slabClasses[sizeClass].liveCount * slabClassSizes[sizeClass];
+}
+
+size_t slabLargeBytes() {
+    return largeBytes;
+}
+
+void printSlabUsage() {
+    printf("Slab usage:\n");
+    for (uint32_t i = 0; i < SLAB_CLASS_COUNT; i++) {
+        if (slabClasses[i].pageCount == 0) continue;
+        printf("    %4zu bytes: %zu held, %zu used\n", slabClassObjectSize(i), slabClassHeldBytes(i), slabClassUsedBytes(i));
+    }
+    printf("    Large: %zu used\n", largeBytes);
+}
+
+// Releases all pages, objects still allocated from them become invalid
+void freeSlabAllocator() {
+#ifdef PRINT_SLAB_USAGE
+    printSlabUsage();
+#endif
+    for (uint32_t i = 0; i < SLAB_CLASS_COUNT; i++) {
+        slabClass* currClass = &slabClasses[i];
+        while (currClass->allPages != NULL) freeSlabPage(currClass, currClass->allPages);
+        currClass->emptyPageCount = 0;
+        currClass->liveCount = 0;
+    }
+}
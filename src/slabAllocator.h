@@ -0,0 +1,32 @@
+//
+// Created by congyu on 10/19/26.
+//
+
+#ifndef CJ_2_SLABALLOCATOR_H
+#define CJ_2_SLABALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+// Size classes grow by a quarter per step above 128 bytes, up to 2048 bytes
+#define SLAB_CLASS_COUNT 24
+
+// Allocations are sized, callers pass the size they allocated with when freeing or resizing.
+// Larger sizes go to malloc. Not thread safe.
+void* slabAlloc(size_t size);
+void* slabCalloc(size_t size);
+void* slabRealloc(void* ptr, size_t oldSize, size_t newSize);
+void slabFree(void* ptr, size_t size);
+
+// Usage of one size class, sizeClass is below SLAB_CLASS_COUNT
+size_t slabClassObjectSize(uint32_t sizeClass);
+size_t slabClassHeldBytes(uint32_t sizeClass);
+size_t slabClassUsedBytes(uint32_t sizeClass);
+size_t slabLargeBytes();
+void printSlabUsage();
+
+void freeSlabAllocator();
+
+#endif //CJ_2_SLABALLOCATOR_H
@@ -0,0 +1,81 @@
+//
+// Created by congyu on 10/19/26.
+//
+
+#include "symbolTable.h"
+#include "refManager.h"
+#include "stringHash.h"
+#include "errors.h"
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static char* builtinSymbolNames[BUILTIN_SYMBOL_COUNT] = {
+    "print", "hashString", "get", "set", "add", "size", "contains",
+    "_iter", "_hasNext", "_next", "_ng",
+    "_add", "_sub", "_mul", "_div", "_mod", "_pow",
+    "_eq", "_neq", "_less", "_more", "_leq", "_meq",
+};
+
+// Maps names to dense IDs, names are owned by the string hash
+refTable* symbolRefTable = NULL;
+char** symbolNames = NULL;
+uint32_t symbolCount = 0;
+uint32_t symbolCapacity = 0;
+
+void initSymbolTable() {
+    symbolRefTable = createRefTable(SYMBOL_TABLE_INIT_SIZE);
+    symbolNames = malloc(sizeof(char*) * SYMBOL_TABLE_INIT_SIZE);
+    if (symbolNames == NULL) raiseExceptionByName("ReferenceTableError", "Failed to allocate memory for symbol table");
+    symbolCount = 0;
+    symbolCapacity = SYMBOL_TABLE_INIT_SIZE;
+    for (uint32_t i = 0; i < BUILTIN_SYMBOL_COUNT; i++) internSymbol(builtinSymbolNames[i]);
+}
+
+void freeSymbolTable() {
+    freeRefTable(symbolRefTable);
+    for (uint32_t i = 0; i < symbolCount; i++) removeReference(symbolNames[i]);
+    free(symbolNames);
+    symbolRefTable = NULL;
+    symbolNames = NULL;
+    symbolCount = 0;
+    symbolCapacity = 0;
+}
+
+uint32_t internSymbol(char* name) {
+    if (refTableContains(symbolRefTable, name)) return refTableGet(symbolRefTable, name);
+    if (symbolCount == symbolCapacity) {
+        if (symbolCapacity >= UINT32_MAX / 2) raiseExceptionByName("ReferenceTableError", "Symbol table overflow");
+        symbolCapacity *= 2;
+        symbolNames = realloc(symbolNames, sizeof(char*) * symbolCapacity);
+        if (symbolNames == NULL) raiseExceptionByName("ReferenceTableError", "Failed to reallocate memory for symbol table");
+    }
+    char* key = addReference(name);
+    symbolNames[symbolCount] = key;
+    symbolCount++;
+    return getRefIndex(symbolRefTable, key);
+}
+
+uint32_t findSymbol(char* name) {
+    if (!refTableContains(symbolRefTable, name)) return SYMBOL_NONE;
+    return refTableGet(symbolRefTable, name);
+}
+
+char* getSymbolName(uint32_t symbol) {
+    if (symbol >= symbolCount) return NULL;
+    return symbolNames[symbol];
+}
+
+uint32_t getSymbolCount() {
+    return symbolCount;
+}
+
+void printSymbolTable() {
+    printf("Symbol table: [");
+    for (uint32_t i = 0; i < symbolCount; i++) {
+        if (i > 0) printf(", ");
+        printf("%u: \"%s\"", i, symbolNames[i]);
+    }
+    printf("]\n");
+}
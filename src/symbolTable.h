@@ -0,0 +1,55 @@
+//
+// Created by congyu on 10/19/26.
+//
+
+#ifndef CJ_2_SYMBOLTABLE_H
+#define CJ_2_SYMBOLTABLE_H
+
+#include <stdint.h>
+
+#define SYMBOL_NONE UINT32_MAX
+
+// Symbols interned at startup, in the order of builtinSymbolNames
+typedef enum builtinSymbol {
+    SYMBOL_PRINT,
+    SYMBOL_HASH_STRING,
+    SYMBOL_GET,
+    SYMBOL_SET,
+    SYMBOL_ADD,
+    SYMBOL_SIZE,
+    SYMBOL_CONTAINS,
+    SYMBOL_ITER,
+    SYMBOL_HAS_NEXT,
+    SYMBOL_NEXT,
+    SYMBOL_OP_NEGATE,
+    SYMBOL_OP_ADD,
+    SYMBOL_OP_SUB,
+    SYMBOL_OP_MUL,
+    SYMBOL_OP_DIV,
+    SYMBOL_OP_MOD,
+    SYMBOL_OP_POW,
+    SYMBOL_OP_EQ,
+    SYMBOL_OP_NEQ,
+    SYMBOL_OP_LESS,
+    SYMBOL_OP_MORE,
+    SYMBOL_OP_LEQ,
+    SYMBOL_OP_MEQ,
+    BUILTIN_SYMBOL_COUNT
+} builtinSymbol;
+
+// Operator method symbols are contiguous so they can index per-class operator slots
+#define FIRST_OPERATOR_SYMBOL SYMBOL_OP_NEGATE
+#define OPERATOR_SYMBOL_COUNT (SYMBOL_OP_MEQ - SYMBOL_OP_NEGATE + 1)
+#define IS_OPERATOR_SYMBOL(s) ((s) >= FIRST_OPERATOR_SYMBOL && (s) <= SYMBOL_OP_MEQ)
+
+void initSymbolTable();
+void freeSymbolTable();
+
+uint32_t internSymbol(char* name);
+uint32_t findSymbol(char* name);
+char* getSymbolName(uint32_t symbol);
+uint32_t getSymbolCount();
+
+void printSymbolTable();
+
+#endif //CJ_2_SYMBOLTABLE_H
@@ -66,7 +66,9 @@ const char *keywords[] = {
         "unrecoverable",
         "handle",
         "try",
-        "raise"
+        "raise",
+        "in",
+        "immutable"
 };
 
 // List of keyword token types
@@ -99,7 +101,9 @@ tokenType keywordTypes[] = {
         KEYWORD_UNRECOVERABLE,
         KEYWORD_HANDLE,
         KEYWORD_TRY,
-        KEYWORD_RAISE
+        KEYWORD_RAISE,
+        KEYWORD_IN,
+        KEYWORD_IMMUTABLE
 };
 
 tokenizer* Tokenizer;
@@ -156,6 +160,7 @@ void initTokenizer(char* sourcefile, char* sourceName) {
     Tokenizer->totalSourceCount = 0;
     Tokenizer->currToken = NULL;
     Tokenizer->startToken = NULL;
+    Tokenizer->endToken = NULL;
     Tokenizer->sourceTable = createRefTable(GLOBAL_REF_TABLE_INIT_SIZE);
     getRefIndex(Tokenizer->sourceTable, sourceName);
 }
@@ -183,13 +188,10 @@ token* createToken(tokenType type, char* value, unsigned int line, unsigned int
     if (Tokenizer->startToken == NULL) {
         Tokenizer->startToken = t;
     } else {
-        token* lastToken = Tokenizer->startToken;
-        while (lastToken->nextToken != NULL) {
-            lastToken = lastToken->nextToken;
-        }
-        lastToken->nextToken = t;
-        t->prevToken = lastToken;
+        Tokenizer->endToken->nextToken = t;
+        t->prevToken = Tokenizer->endToken;
     }
+    Tokenizer->endToken = t;
     return t;
 }
 
@@ -227,30 +229,33 @@ token* nextNumberToken() { // Called when CURR_CHAR location is at first digit
 }
 
 token* nextIdentifierToken() { // Called when CURR_CHAR location is at first letter
-    char buf[IDENTIFIER_BUFFER_SIZE]; // Buffer for the identifier
-    int idx = 0;
     bool isIdentifier = false;
     unsigned int startingIndex = Tokenizer->currIndex;
+    char* startingChar = Tokenizer->currChar;
 
     // Collect characters until we hit a non-alphabetic character
-    while ((IS_ALPHA(CURR_CHAR) || IS_DIGIT(CURR_CHAR) || CURR_CHAR == '_') && idx < sizeof(buf) - 1) {
+    while (IS_ALPHA(CURR_CHAR) || IS_DIGIT(CURR_CHAR) || CURR_CHAR == '_') {
         // Check if we have an identifier ahead of comparing string
         if (IS_DIGIT(CURR_CHAR) || CURR_CHAR == '_') isIdentifier = true;
-        buf[idx++] = CURR_CHAR;
         INC_CHAR(); // increment to next char
     }
-    buf[idx] = '\0'; // null terminate the string
+    // Copy identifier of any length
+    unsigned int length = Tokenizer->currIndex - startingIndex;
+    char* str = (char*)malloc(sizeof(char) * (length + 1));
+    for (int i = 0; i < length; i++) str[i] = *(startingChar + i);
+    str[length] = '\0'; // null terminate the string
     // If already an identifier, return identifier token
-    if (isIdentifier) return createToken(IDENTIFIER, strdup(buf), Tokenizer->currLine, startingIndex);
+    if (isIdentifier) return createToken(IDENTIFIER, str, Tokenizer->currLine, startingIndex);
     // Check if the string matches a keyword
     for (int i = 0; i < sizeof(keywords)/sizeof(keywords[0]); i++) {
-        if (strcmp(buf, keywords[i]) == 0) {
+        if (strcmp(str, keywords[i]) == 0) {
             // If it's a keyword, return a token of the keyword's type
+            free(str);
             return createToken(keywordTypes[i], NULL, Tokenizer->currLine, startingIndex);
         }
     }
     // Determined as an identifier
-    return createToken(IDENTIFIER, strdup(buf), Tokenizer->currLine, startingIndex);
+    return createToken(IDENTIFIER, str, Tokenizer->currLine, startingIndex);
 }
 
 token* nextStringToken() { // Called when CURR_CHAR location is at first string character
@@ -88,6 +88,8 @@ typedef enum tokenType {
     KEYWORD_HANDLE,
     KEYWORD_TRY,
     KEYWORD_RAISE,
+    KEYWORD_IN,
+    KEYWORD_IMMUTABLE,
 
     // Identifier
     IDENTIFIER
@@ -117,6 +119,7 @@ typedef struct tokenizer {
     unsigned int currIndex;
     token* currToken;
     token* startToken;
+    token* endToken;
     refTable* sourceTable;
 } tokenizer;
 
@@ -5,7 +5,11 @@
 #include "vm.h"
 #include "errors.h"
 #include "objectManager.h"
+#include "objShape.h"
+#include "objClass.h"
 #include "compiler.h"
+#include "runtimeDS.h"
+#include "runtimeMemoryManager.h"
 
 #include <math.h>
 #include <string.h>
@@ -173,6 +177,122 @@ static inline Value payloadNumBinaryComp(double val1, double val2, OpCode op) {
     return INTERNAL_NULL_VAL; // Unreachable
 }
 
+// Equality of builtin scalars, strings and callables, matching equalPrim.
+// Returns false when v1 needs _eq dispatch.
+static inline bool builtinEquals(Value v1, Value v2, bool* result) {
+    switch (VALUE_TYPE(v1)) {
+        case VAL_NONE:
+            *result = VALUE_TYPE(v2) == VAL_NONE;
+            return true;
+        case VAL_BOOL:
+            *result = VALUE_TYPE(v2) == VAL_BOOL && VALUE_BOOL_VALUE(v1) == VALUE_BOOL_VALUE(v2);
+            return true;
+        case VAL_NUMBER:
+            *result = VALUE_TYPE(v2) == VAL_NUMBER && fabs(VALUE_NUMBER_VALUE(v1) - VALUE_NUMBER_VALUE(v2)) < 1e-9;
+            return true;
+        case BUILTIN_CALLABLE:
+            *result = VALUE_TYPE(v2) == BUILTIN_CALLABLE && v1.obj == v2.obj;
+            return true;
+        case BUILTIN_STR:
+            // Strings are interned, equal contents share one pointer
+            *result = VALUE_TYPE(v2) == BUILTIN_STR && VALUE_STR_VALUE(v1) == VALUE_STR_VALUE(v2);
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline void execMethodInplace(uint8_t inputCount, bool enforceReturn) {
+    // Get callable object
+    Value callableObj = *(vm->stackTop-(inputCount+1));
+    // If callable position is self, get callable from previous position
+    if (VALUE_TYPE(callableObj) != BUILTIN_CALLABLE) callableObj = *(vm->stackTop-(inputCount+2));
+    // Check if callable
+    if (VALUE_TYPE(callableObj) != BUILTIN_CALLABLE) {
+        raiseExceptionByName("TypeError", "Object is not callable");
+        return;
+    }
+    // Check if callable has output for enforce return
+    if (VALUE_CALLABLE_VALUE(callableObj)->out == 0 && enforceReturn) {
+        raiseExceptionByName("ValueError", "Callable has no output");
+        return;
+    }
+    // Execute callable
+    execInplace(callableObj, inputCount);
+    // Ignore return object if necessary
+    if (VALUE_CALLABLE_VALUE(callableObj)->out == 1 && !enforceReturn) vm->stackTop--;
+}
+
+// Executes a builtin collection method without attribute lookup. Returns false
+// if the receiver or argument count does not match, leaving the stack untouched.
+static inline bool invokeIntrinsic(intrinsicMethod intrinsic, Value self, Value* args, uint8_t numArgs, bool enforceReturn, Value* result) {
+    switch (intrinsic) {
+        case INTRINSIC_ADD: {
+            // No output, let the slow path report enforced return
+            if (enforceReturn) return false;
+            if (VALUE_TYPE(self) == BUILTIN_LIST && numArgs == 1) {
+                listAddElement(VALUE_LIST_VALUE(self), args[0]);
+                GC_WRITE_BARRIER(self.obj, args[0]);
+            } else if (VALUE_TYPE(self) == BUILTIN_SET && numArgs == 1) {
+                setInsertElement(VALUE_SET_VALUE(self), args[0]);
+                GC_WRITE_BARRIER(self.obj, args[0]);
+            } else if (VALUE_TYPE(self) == BUILTIN_DICT && numArgs == 2) {
+                dictInsertElement(VALUE_DICT_VALUE(self), args[0], args[1]);
+                GC_WRITE_BARRIER(self.obj, args[0]);
+                GC_WRITE_BARRIER(self.obj, args[1]);
+            } else if (IS_ARRAY_TYPE(VALUE_TYPE(self)) && numArgs == 1 && VALUE_TYPE(args[0]) == VAL_NUMBER) {
+                arrayAddElement(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self), VALUE_NUMBER_VALUE(args[0]));
+            } else {
+                return false;
+            }
+            *result = NONE_VAL;
+            return true;
+        }
+        case INTRINSIC_GET: {
+            if (numArgs != 1) return false;
+            if (VALUE_TYPE(self) == BUILTIN_LIST) {
+                if (VALUE_TYPE(args[0]) != VAL_NUMBER) {
+                    raiseExceptionByName("TypeError", "Value is not of type num");
+                    return true;
+                }
+                *result = listGetElement(VALUE_LIST_VALUE(self), VALUE_NUMBER_VALUE(args[0]));
+                return true;
+            }
+            if (VALUE_TYPE(self) == BUILTIN_DICT) {
+                *result = dictGetElement(VALUE_DICT_VALUE(self), args[0]);
+                return true;
+            }
+            if (IS_ARRAY_TYPE(VALUE_TYPE(self)) && VALUE_TYPE(args[0]) == VAL_NUMBER) {
+                *result = arrayGetElement(VALUE_ARRAY_VALUE(self), VALUE_ARRAY_IS_INT(self), VALUE_NUMBER_VALUE(args[0]));
+                return true;
+            }
+            return false;
+        }
+        case INTRINSIC_SIZE: {
+            if (numArgs != 0) return false;
+            switch (VALUE_TYPE(self)) {
+                case BUILTIN_LIST: *result = NUMBER_VAL(VALUE_LIST_VALUE(self)->size); return true;
+                case BUILTIN_DICT: *result = NUMBER_VAL(VALUE_DICT_VALUE(self)->numEntries); return true;
+                case BUILTIN_SET: *result = NUMBER_VAL(VALUE_SET_VALUE(self)->numEntries); return true;
+                case BUILTIN_FLOAT_ARRAY:
+                case BUILTIN_INT_ARRAY: *result = NUMBER_VAL(VALUE_ARRAY_VALUE(self)->size); return true;
+                default: return false;
+            }
+        }
+        case INTRINSIC_CONTAINS: {
+            if (numArgs != 1) return false;
+            switch (VALUE_TYPE(self)) {
+                case BUILTIN_LIST: *result = BOOL_VAL(listContainsElement(VALUE_LIST_VALUE(self), args[0])); return true;
+                case BUILTIN_DICT: *result = BOOL_VAL(dictContainsElement(VALUE_DICT_VALUE(self), args[0])); return true;
+                case BUILTIN_SET: *result = BOOL_VAL(setContainsElement(VALUE_SET_VALUE(self), args[0])); return true;
+                default: return false;
+            }
+        }
+        default:
+            return false;
+    }
+}
+
 void execChunk(Chunk* chunk, Value* dataSection) {
     if (chunk == NULL) raiseExceptionByName("InternalError", "Chunk is NULL");
     uint64_t* ip = chunk->code;
@@ -197,29 +317,19 @@ void execChunk(Chunk* chunk, Value* dataSection) {
         OpCode op = (uint8_t)(line & 0xFF);
         switch (op) {
             case OP_CONSTANT: {
-                STACK_PUSH(CONST_REF(GET_BYTE(1)));
+                STACK_PUSH(CONST_REF(GET_DWORD(1)));
                 break;
             }
             case OP_GET_ATTR: {
-                Value attrName = CONST_REF(GET_BYTE(1));
-                if (VALUE_TYPE(attrName) != BUILTIN_STR) {
-                    raiseExceptionByName("TypeError", "Attribute name is not a string");
-                    break;
-                }
                 Value obj = STACK_POP();
-                Value attrObj = getAttr(obj, VALUE_STR_VALUE(attrName));
+                Value attrObj = getAttr(obj, GET_DWORD(1));
                 // Insert new object
                 STACK_PUSH(attrObj);
                 break;
             }
             case OP_GET_ATTR_CALL: {
-                Value attrName = CONST_REF(GET_BYTE(1));
-                if (VALUE_TYPE(attrName) != BUILTIN_STR) {
-                    raiseExceptionByName("TypeError", "Attribute name is not a string");
-                    break;
-                }
                 Value obj = STACK_POP();
-                Value attrObj = getAttr(obj, VALUE_STR_VALUE(attrName));
+                Value attrObj = getAttr(obj, GET_DWORD(1));
                 // Insert new object
                 STACK_PUSH(attrObj);
                 // Reinsert self
@@ -228,7 +338,7 @@ void execChunk(Chunk* chunk, Value* dataSection) {
             }
             case OP_GET_GLOBAL_REF_ATTR: {
                 // Push attribute object
-                Value retrievedObj = GLOBAL_REF(GET_WORD(1));
+                Value retrievedObj = GLOBAL_REF(GET_DWORD(1));
                 if (IS_INTERNAL_NULL(retrievedObj)) {
                     raiseExceptionByName("ReferenceError", "Global reference not found");
                     break;
@@ -251,7 +361,7 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 // Get local ref
                 Value retrievedObj = LOCAL_REF(GET_WORD(1));
                 if (IS_INTERNAL_NULL(retrievedObj)) { // Search in global ref array
-                    retrievedObj = GLOBAL_REF(GET_WORD(3));
+                    retrievedObj = GLOBAL_REF(GET_DWORD(3));
                 }
                 if (IS_INTERNAL_NULL(retrievedObj)) {
                     raiseExceptionByName("ReferenceError", "Reference not found");
@@ -263,8 +373,8 @@ void execChunk(Chunk* chunk, Value* dataSection) {
             }
             case OP_SET_GLOBAL_REF_ATTR: {
                 // Get special assignment
-                specialAssignment sa = GET_BYTE(3);
-                uint16_t globalIndex = GET_WORD(1);
+                specialAssignment sa = GET_BYTE(5);
+                uint32_t globalIndex = GET_DWORD(1);
                 if (sa != ASSIGNMENT_NONE) {
                     Value retrievedObj = GLOBAL_REF(globalIndex);
                     if (IS_INTERNAL_NULL(retrievedObj)) {
@@ -318,9 +428,9 @@ void execChunk(Chunk* chunk, Value* dataSection) {
             }
             case OP_SET_COMBINED_REF_ATTR: {
                 uint16_t localIndex = GET_WORD(1);
-                uint16_t globalIndex = GET_WORD(3);
+                uint32_t globalIndex = GET_DWORD(3);
                 // Get special assignment
-                specialAssignment sa = GET_BYTE(5);
+                specialAssignment sa = GET_BYTE(7);
                 Value val = STACK_POP();
                 // If we are modifying a reference
                 if (sa != ASSIGNMENT_NONE) {
@@ -472,12 +582,17 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 } else {
                     if (IS_INTERNAL_NULL(rightObj)) rightObj = NUMBER_VAL(rightVal);
                     if (IS_INTERNAL_NULL(leftObj)) leftObj = NUMBER_VAL(leftVal);
-                    STACK_PUSH(binaryOperation(leftObj, rightObj, op));
+                    bool equal;
+                    if ((op == OP_EQUAL || op == OP_NOT_EQUAL) && builtinEquals(leftObj, rightObj, &equal)) {
+                        STACK_PUSH(BOOL_VAL(op == OP_EQUAL ? equal : !equal));
+                    } else {
+                        STACK_PUSH(binaryOperation(leftObj, rightObj, op));
+                    }
                 }
                 break;
             }
             case OP_NEGATE:
-                STACK_PUSH(unaryOperation(STACK_POP(), "_ng"));
+                STACK_PUSH(unaryOperation(STACK_POP(), SYMBOL_OP_NEGATE));
                 break;
             case OP_NOT: {
                 Value obj = STACK_POP();
@@ -509,7 +624,7 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 break;
             }
             case OP_JUMP: {
-                int16_t jumpInc = GET_WORD(1);
+                int32_t jumpInc = GET_DWORD(1);
                 ip--;
                 ip += jumpInc;
                 break;
@@ -521,12 +636,38 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                     break;
                 }
                 if (!VALUE_BOOL_VALUE(condition)) {
-                    int16_t jumpInc = GET_WORD(1);
+                    int32_t jumpInc = GET_DWORD(1);
                     ip--;
                     ip += jumpInc;
                 }
                 break;
             }
+            case OP_ITER_INIT: {
+                initIterator(&LOCAL_REF(GET_WORD(1)), STACK_POP());
+                break;
+            }
+            case OP_ITER_NEXT: {
+                Value* iterator = &LOCAL_REF(GET_WORD(5));
+                // Walk list directly
+                if (VALUE_TYPE(iterator[0]) == BUILTIN_LIST) {
+                    runtimeList* list = VALUE_LIST_VALUE(iterator[0]);
+                    uint32_t index = (uint32_t) VALUE_NUMBER_VALUE(iterator[1]);
+                    if (index < list->size) {
+                        VALUE_NUMBER_VALUE(iterator[1]) += 1;
+                        STACK_PUSH(list->list[index]);
+                        break;
+                    }
+                } else if (iteratorNext(iterator)) {
+                    break;
+                }
+                if (vm->panic) break;
+                // Release collection and jump to loop end
+                iterator[0] = NONE_VAL;
+                int32_t jumpInc = GET_DWORD(1);
+                ip--;
+                ip += jumpInc;
+                break;
+            }
             case OP_RETURN:
                 // Pop ip from stack
                 ipStackTop--;
@@ -550,6 +691,19 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 // Get objects
                 Value indexObj = STACK_POP();
                 Value targetObj = STACK_POP();
+                // Inline list access, other targets dispatch by type
+                if (VALUE_TYPE(targetObj) == BUILTIN_LIST && VALUE_TYPE(indexObj) == VAL_NUMBER) {
+                    STACK_PUSH(listGetElement(VALUE_LIST_VALUE(targetObj), VALUE_NUMBER_VALUE(indexObj)));
+                    break;
+                }
+                if (IS_ARRAY_TYPE(VALUE_TYPE(targetObj)) && VALUE_TYPE(indexObj) == VAL_NUMBER) {
+                    runtimeArray* array = VALUE_ARRAY_VALUE(targetObj);
+                    uint32_t index = (uint32_t) VALUE_NUMBER_VALUE(indexObj);
+                    if (index < array->size) {
+                        STACK_PUSH(NUMBER_VAL(VALUE_ARRAY_IS_INT(targetObj) ? (double) array->ints[index] : array->floats[index]));
+                        break;
+                    }
+                }
                 STACK_PUSH(objGetIndexRef(targetObj, indexObj));
                 break;
             }
@@ -564,30 +718,15 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 if (sa != ASSIGNMENT_NONE) {
                     indexSpecialAssignment(sa, target, index, value);
                 } else {
-                    // Check index is num
-                    if (VALUE_TYPE(index) != VAL_NUMBER) {
-                        raiseExceptionByName("TypeError", "Index is not a num");
-                        break;
-                    }
-                    // Get index set method
-                    Value indexSetMethod = getAttr(target, "set");
-                    // Prepare input array
-                    Value inputs[2] = {index, value};
-                    // Execute index set method
-                    execInput(indexSetMethod, target, inputs, 2);
+                    objSetIndexRef(target, index, value);
                 }
                 break;
             }
             case OP_SET_ATTR: {
-                // Get attribute name
-                Value attrName = CONST_REF(GET_BYTE(1));
-                // Check if attribute name is a string
-                if (VALUE_TYPE(attrName) != BUILTIN_STR) {
-                    raiseExceptionByName("TypeError", "Attribute name is not a string");
-                    break;
-                }
+                // Get attribute symbol
+                uint32_t attrSymbol = GET_DWORD(1);
                 // Get special assignment
-                specialAssignment sa = GET_BYTE(2);
+                specialAssignment sa = GET_BYTE(5);
                 // Get Value and target objects
                 Value value = STACK_POP();
                 Value target = STACK_POP();
@@ -596,9 +735,9 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                     break;
                 }
                 if (sa != ASSIGNMENT_NONE) {
-                    attrSpecialAssignment(sa, target, VALUE_STR_VALUE(attrName), value);
+                    attrSpecialAssignment(sa, target, attrSymbol, value);
                 } else {
-                    strValInsert(target.obj->primValue.afterDefAttributes, VALUE_STR_VALUE(attrName), value);
+                    objAttrSet(target.obj, attrSymbol, value);
                 }
                 break;
             }
@@ -606,7 +745,7 @@ void execChunk(Chunk* chunk, Value* dataSection) {
             case OP_EXEC_FUNCTION_IGNORE_RETURN: {
                 // Get call parameters
                 uint8_t attrCount = GET_BYTE(1);
-                callable* targetCallable = functionArray[GET_WORD(2)];
+                callable* targetCallable = functionArray[GET_DWORD(2)];
                 // Check callable output count
                 if (op == OP_EXEC_FUNCTION_ENFORCE_RETURN && targetCallable->out == 0)
                     raiseExceptionByName("InternalError", "Callable has no output");
@@ -632,26 +771,29 @@ void execChunk(Chunk* chunk, Value* dataSection) {
             }
             case OP_EXEC_METHOD_ENFORCE_RETURN:
             case OP_EXEC_METHOD_IGNORE_RETURN: {
-                // Get input count
-                uint8_t inputCount = GET_BYTE(1);
-                // Get callable object
-                Value callableObj = *(vm->stackTop-(inputCount+1));
-                // If callable position is self, get callable from previous position
-                if (VALUE_TYPE(callableObj) != BUILTIN_CALLABLE) callableObj = *(vm->stackTop-(inputCount+2));
-                // Check if callable
-                if (VALUE_TYPE(callableObj) != BUILTIN_CALLABLE) {
-                    raiseExceptionByName("TypeError", "Object is not callable");
-                    break;
-                }
-                // Check if callable has output for enforce return
-                if (VALUE_CALLABLE_VALUE(callableObj)->out == 0 && op == OP_EXEC_METHOD_ENFORCE_RETURN) {
-                    raiseExceptionByName("ValueError", "Callable has no output");
+                execMethodInplace(GET_BYTE(1), op == OP_EXEC_METHOD_ENFORCE_RETURN);
+                break;
+            }
+            case OP_INVOKE_INTRINSIC_ENFORCE_RETURN:
+            case OP_INVOKE_INTRINSIC_IGNORE_RETURN: {
+                uint8_t inputCount = GET_BYTE(5);
+                bool enforceReturn = op == OP_INVOKE_INTRINSIC_ENFORCE_RETURN;
+                Value* selfPtr = vm->stackTop-(inputCount+1);
+                Value result;
+                // Fast path for builtin list, dict & set receivers
+                if (invokeIntrinsic((intrinsicMethod) GET_BYTE(6), *selfPtr, selfPtr+1, inputCount, enforceReturn, &result)) {
+                    if (vm->panic) break;
+                    vm->stackTop = selfPtr;
+                    if (enforceReturn) STACK_PUSH(result);
                     break;
                 }
-                // Execute callable
-                execInplace(callableObj, inputCount);
-                // Ignore return object if necessary
-                if (VALUE_CALLABLE_VALUE(callableObj)->out == 1 && op == OP_EXEC_METHOD_IGNORE_RETURN) vm->stackTop--;
+                // Slow path, resolve attribute and insert it below self
+                Value attrObj = getAttr(*selfPtr, GET_DWORD(1));
+                if (vm->panic) break;
+                memmove(selfPtr+1, selfPtr, (inputCount+1) * sizeof(Value));
+                *selfPtr = attrObj;
+                vm->stackTop++;
+                execMethodInplace(inputCount, enforceReturn);
                 break;
             }
             case OP_INIT: {
@@ -696,8 +838,8 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 vm->handlerStackTop->ipLoc = &ip;
                 vm->handlerStackTop->stackLoc = vm->stackTop;
                 vm->handlerStackTop->batchCount = GET_BYTE(1);
-                vm->handlerStackTop->toLine = GET_WORD(2);
-                vm->handlerStackTop->type = GET_WORD(4);
+                vm->handlerStackTop->toLine = GET_DWORD(2);
+                vm->handlerStackTop->type = GET_WORD(6);
                 vm->handlerStackTop->handlesAll = false;
                 vm->handlerStackTop++;
                 break;
@@ -706,7 +848,7 @@ void execChunk(Chunk* chunk, Value* dataSection) {
                 vm->handlerStackTop->ipLoc = &ip;
                 vm->handlerStackTop->stackLoc = vm->stackTop;
                 vm->handlerStackTop->batchCount = GET_BYTE(1);
-                vm->handlerStackTop->toLine = GET_WORD(2);
+                vm->handlerStackTop->toLine = GET_DWORD(2);
                 vm->handlerStackTop->handlesAll = true;
                 vm->handlerStackTop++;
                 break;
@@ -760,19 +902,11 @@ void execChunk(Chunk* chunk, Value* dataSection) {
     }
 }
 
-bool compareValue(Value v1, Value v2) {
-    Value result = binaryOperation(v1, v2, OP_EQUAL);
-    if (VALUE_TYPE(result) != VAL_BOOL) {
-        raiseExceptionByName("ValueError", "Result of _eq is not a boolean");
-        return false;
-    }
-    return VALUE_BOOL_VALUE(result);
-}
-
-void initVM(Value* globalRefArray, callable** functionArray, uint16_t globalRefCount) {
+void initVM(Value* globalRefArray, callable** functionArray, uint32_t globalRefCount) {
     vm = (VM*)malloc(sizeof(VM));
     vm->stackTop = vm->stack;
     vm->handlerStackTop = vm->handlerStack;
+    vm->panic = false;
     vm->globalRefArray = globalRefArray;
     vm->functionArray = functionArray;
     vm->globalRefCount = globalRefCount;
@@ -785,81 +919,107 @@ void initVM(Value* globalRefArray, callable** functionArray, uint16_t globalRefC
 #endif
 }
 
-Value unaryOperation(Value obj1, char* op) {
-    Value opFunction = ignoreNullGetAttr(obj1, op);
+static inline Value findOperator(Value val, uint32_t opSymbol) {
+    if (IS_INTERNAL_NULL(val)) return ignoreNullGetAttr(val, opSymbol);
+    if (!IS_SYSTEM_DEFINED_TYPE(VALUE_TYPE(val))) {
+        // Instance attributes may shadow the class operator
+        objAttrs* attrs = VALUE_ATTRS(val);
+        if (OBJ_ATTRS_IS_DICT_MODE(attrs) || attrs->shape->hasOperatorAttrs) return ignoreNullGetAttr(val, opSymbol);
+    }
+    objClass* c = VALUE_CLASS(val);
+    if (c == NULL) return INTERNAL_NULL_VAL;
+    return CLASS_FIND_OPERATOR(c, opSymbol);
+}
+
+bool compareValue(Value v1, Value v2) {
+    bool equal;
+    if (builtinEquals(v1, v2, &equal)) return equal;
+    // Objects without _eq compare by identity, matching their default hash
+    if (IS_INTERNAL_NULL(findOperator(v1, SYMBOL_OP_EQ)) && IS_INTERNAL_NULL(findOperator(v2, SYMBOL_OP_EQ)))
+        return v1.obj == v2.obj;
+    Value result = binaryOperation(v1, v2, OP_EQUAL);
+    if (VALUE_TYPE(result) != VAL_BOOL) {
+        raiseExceptionByName("ValueError", "Result of _eq is not a boolean");
+        return false;
+    }
+    return VALUE_BOOL_VALUE(result);
+}
+
+Value unaryOperation(Value obj1, uint32_t op) {
+    Value opFunction = findOperator(obj1, op);
     if (IS_INTERNAL_NULL(opFunction)) raiseExceptionByName("InternalError", "No operator function found");
     return execInput(opFunction, obj1, NULL, 0);
 }
 
 Value binaryOperation(Value v1, Value v2, OpCode op) {
-    char* leftOpStr = NULL;
-    char* rightOpStr = NULL;
+    uint32_t leftOpSymbol = SYMBOL_NONE;
+    uint32_t rightOpSymbol = SYMBOL_NONE;
     switch (op) {
         case OP_ADD: {
-            leftOpStr = "_add";
-            rightOpStr = "_add";
+            leftOpSymbol = SYMBOL_OP_ADD;
+            rightOpSymbol = SYMBOL_OP_ADD;
             break;
         }
         case OP_SUB: {
-            leftOpStr = "_sub";
+            leftOpSymbol = SYMBOL_OP_SUB;
             break;
         }
         case OP_MUL: {
-            leftOpStr = "_mul";
-            rightOpStr = "_mul";
+            leftOpSymbol = SYMBOL_OP_MUL;
+            rightOpSymbol = SYMBOL_OP_MUL;
             break;
         }
         case OP_DIV: {
-            leftOpStr = "_div";
+            leftOpSymbol = SYMBOL_OP_DIV;
             break;
         }
         case OP_MOD: {
-            leftOpStr = "_mod";
+            leftOpSymbol = SYMBOL_OP_MOD;
             break;
         }
         case OP_POW: {
-            leftOpStr = "_pow";
+            leftOpSymbol = SYMBOL_OP_POW;
             break;
         }
         case OP_EQUAL: {
-            leftOpStr = "_eq";
-            rightOpStr = "_eq";
+            leftOpSymbol = SYMBOL_OP_EQ;
+            rightOpSymbol = SYMBOL_OP_EQ;
             break;
         }
         case OP_NOT_EQUAL: {
-            leftOpStr = "_neq";
-            rightOpStr = "_neq";
+            leftOpSymbol = SYMBOL_OP_NEQ;
+            rightOpSymbol = SYMBOL_OP_NEQ;
             break;
         }
         case OP_LESS: {
-            leftOpStr = "_less";
-            rightOpStr = "_meq";
+            leftOpSymbol = SYMBOL_OP_LESS;
+            rightOpSymbol = SYMBOL_OP_MEQ;
             break;
         }
         case OP_MORE: {
-            leftOpStr = "_more";
-            rightOpStr = "_leq";
+            leftOpSymbol = SYMBOL_OP_MORE;
+            rightOpSymbol = SYMBOL_OP_LEQ;
             break;
         }
         case OP_LESS_EQUAL: {
-            leftOpStr = "_leq";
-            rightOpStr = "_more";
+            leftOpSymbol = SYMBOL_OP_LEQ;
+            rightOpSymbol = SYMBOL_OP_MORE;
             break;
         }
         case OP_MORE_EQUAL: {
-            leftOpStr = "_meq";
-            rightOpStr = "_less";
+            leftOpSymbol = SYMBOL_OP_MEQ;
+            rightOpSymbol = SYMBOL_OP_LESS;
             break;
         }
         default:
             raiseExceptionByName("InternalError", "Invalid binary operation type");
     }
-    Value opFunction = ignoreNullGetAttr(v1, leftOpStr);
+    Value opFunction = findOperator(v1, leftOpSymbol);
     if (!IS_INTERNAL_NULL(opFunction)) {
         return execInput(opFunction, v1, &v2, 1);
     }
-    if (rightOpStr != NULL) {
-        opFunction = ignoreNullGetAttr(v2, rightOpStr);
+    if (rightOpSymbol != SYMBOL_NONE) {
+        opFunction = findOperator(v2, rightOpSymbol);
         if (!IS_INTERNAL_NULL(opFunction)) {
             return execInput(opFunction, v2, &v1, 1);
         }
@@ -910,38 +1070,216 @@ Value performValueModification(specialAssignment sa, Value value, Value modValue
     }
 }
 
+// Checks the index as a double, converting a negative, NaN or huge one to uint32_t is undefined
+static inline bool isIndexInRange(double index, uint32_t size) {
+    return index >= 0 && index < size && index == floor(index);
+}
+
 void indexSpecialAssignment(specialAssignment sa , Value target, Value index, Value value) {
+    switch (VALUE_TYPE(target)) {
+        case BUILTIN_LIST: {
+            if (VALUE_TYPE(index) != VAL_NUMBER) break;
+            runtimeList* list = VALUE_LIST_VALUE(target);
+            if (!isIndexInRange(VALUE_NUMBER_VALUE(index), list->size)) {
+                raiseExceptionByName("ParameterError", "List index out of range");
+                return;
+            }
+            uint32_t i = VALUE_NUMBER_VALUE(index);
+            Value modifiedValue = performValueModification(sa, list->list[i], value);
+            if (vm->panic) return;
+            // Operator methods may have resized the list
+            listSetElement(list, i, modifiedValue);
+            GC_WRITE_BARRIER(target.obj, modifiedValue);
+            return;
+        }
+        case BUILTIN_FLOAT_ARRAY:
+        case BUILTIN_INT_ARRAY: {
+            if (VALUE_TYPE(index) != VAL_NUMBER || VALUE_TYPE(value) != VAL_NUMBER) break;
+            runtimeArray* array = VALUE_ARRAY_VALUE(target);
+            bool isInt = VALUE_ARRAY_IS_INT(target);
+            if (!isIndexInRange(VALUE_NUMBER_VALUE(index), array->size)) {
+                raiseExceptionByName("ParameterError", "Array index out of range");
+                return;
+            }
+            uint32_t i = VALUE_NUMBER_VALUE(index);
+            // Number modification runs no user code
+            Value retrievedObj = arrayGetElement(array, isInt, i);
+            Value modifiedValue = performValueModification(sa, retrievedObj, value);
+            if (vm->panic) return;
+            arraySetElement(array, isInt, i, VALUE_NUMBER_VALUE(modifiedValue));
+            return;
+        }
+        case BUILTIN_DICT: {
+            runtimeDict* dict = VALUE_DICT_VALUE(target);
+            Value* valueRef = dictGetValueRef(dict, index);
+            if (valueRef == NULL) {
+                raiseExceptionByName("ParameterError", "Key not found in dictionary");
+                return;
+            }
+            Value retrievedObj = *valueRef;
+            // Number modification runs no user code, update entry in place
+            if (VALUE_TYPE(retrievedObj) == VAL_NUMBER && VALUE_TYPE(value) == VAL_NUMBER) {
+                *valueRef = performValueModification(sa, retrievedObj, value);
+                return;
+            }
+            Value modifiedValue = performValueModification(sa, retrievedObj, value);
+            if (vm->panic) return;
+            dictInsertElement(dict, index, modifiedValue);
+            GC_WRITE_BARRIER(target.obj, modifiedValue);
+            return;
+        }
+        default:
+            break;
+    }
     Value retrievedObj = objGetIndexRef(target, index);
-    Value modifiedValue = performValueModification(sa, retrievedObj, value); 
-    // Get index set method
-    Value indexSetMethod = getAttr(target, "set");
-    // Prepare input array
-    Value inputs[2] = {index, modifiedValue};
-    // Execute index set method
-    execInput(indexSetMethod, target, inputs, 2);
+    if (vm->panic) return;
+    Value modifiedValue = performValueModification(sa, retrievedObj, value);
+    if (vm->panic) return;
+    objSetIndexRef(target, index, modifiedValue);
 }
 
-void attrSpecialAssignment(specialAssignment sa, Value target, char* attrName, Value value) {
+void attrSpecialAssignment(specialAssignment sa, Value target, uint32_t attrSymbol, Value value) {
     // Get attribute original Value
-    Value originalAttribute = getAttr(target, attrName); // getAttr is protected from NULL target
+    Value originalAttribute = getAttr(target, attrSymbol); // getAttr is protected from NULL target
     // Modify Value and re-insert as attribute
     Value modifiedValue = performValueModification(sa, originalAttribute, value);
-    strValInsert(target.obj->primValue.afterDefAttributes, attrName, modifiedValue);
+    objAttrSet(target.obj, attrSymbol, modifiedValue);
 }
 
 Value objGetIndexRef(Value target, Value index) {
+    // Builtin collections are accessed directly
+    if (VALUE_TYPE(target) == BUILTIN_DICT) return dictGetElement(VALUE_DICT_VALUE(target), index);
     // Get index object
     if (VALUE_TYPE(index) != VAL_NUMBER) {
         raiseExceptionByName("TypeError", "Index object is not num");
         return NONE_VAL;
     }
+    if (VALUE_TYPE(target) == BUILTIN_LIST) return listGetElement(VALUE_LIST_VALUE(target), VALUE_NUMBER_VALUE(index));
+    if (IS_ARRAY_TYPE(VALUE_TYPE(target))) return arrayGetElement(VALUE_ARRAY_VALUE(target), VALUE_ARRAY_IS_INT(target), VALUE_NUMBER_VALUE(index));
     // Get index reference method
-    Value indexRefMethod = getAttr(target, "get");
+    Value indexRefMethod = getAttr(target, SYMBOL_GET);
+    if (vm->panic) return NONE_VAL;
     if (VALUE_CALLABLE_VALUE(indexRefMethod)->out == 0)
         raiseExceptionByName("ReturnCountError", "Index reference method has no output");
     return execInput(indexRefMethod, target, &index, 1);
 }
 
+void objSetIndexRef(Value target, Value index, Value value) {
+    // Builtin collections are modified directly
+    if (VALUE_TYPE(target) == BUILTIN_DICT) {
+        dictInsertElement(VALUE_DICT_VALUE(target), index, value);
+        GC_WRITE_BARRIER(target.obj, index);
+        GC_WRITE_BARRIER(target.obj, value);
+        return;
+    }
+    // Check index is num
+    if (VALUE_TYPE(index) != VAL_NUMBER) {
+        raiseExceptionByName("TypeError", "Index is not a num");
+        return;
+    }
+    if (VALUE_TYPE(target) == BUILTIN_LIST) {
+        listSetElement(VALUE_LIST_VALUE(target), VALUE_NUMBER_VALUE(index), value);
+        GC_WRITE_BARRIER(target.obj, value);
+        return;
+    }
+    if (IS_ARRAY_TYPE(VALUE_TYPE(target))) {
+        if (VALUE_TYPE(value) != VAL_NUMBER) {
+            raiseExceptionByName("TypeError", "Value is not of type num");
+            return;
+        }
+        arraySetElement(VALUE_ARRAY_VALUE(target), VALUE_ARRAY_IS_INT(target), VALUE_NUMBER_VALUE(index), VALUE_NUMBER_VALUE(value));
+        return;
+    }
+    // Get index set method
+    Value indexSetMethod = getAttr(target, SYMBOL_SET);
+    if (vm->panic) return;
+    // Prepare input array
+    Value inputs[2] = {index, value};
+    // Execute index set method
+    execInput(indexSetMethod, target, inputs, 2);
+}
+
+void initIterator(Value* iterator, Value collection) {
+    // Iterator slots: collection, cursor
+    iterator[0] = NONE_VAL;
+    iterator[1] = NUMBER_VAL(0);
+    switch (VALUE_TYPE(collection)) {
+        case BUILTIN_LIST:
+        case BUILTIN_DICT:
+        case BUILTIN_SET:
+        case BUILTIN_FLOAT_ARRAY:
+        case BUILTIN_INT_ARRAY:
+            iterator[0] = collection;
+            return;
+        default:
+            break;
+    }
+    if (IS_SYSTEM_DEFINED_TYPE(VALUE_TYPE(collection))) {
+        raiseExceptionByName("TypeError", "Object is not iterable");
+        return;
+    }
+    // User defined iterator protocol, _iter is optional
+    Value iterMethod = ignoreNullGetAttr(collection, SYMBOL_ITER);
+    if (!IS_INTERNAL_NULL(iterMethod)) {
+        collection = execInput(iterMethod, collection, NULL, 0);
+        if (vm->panic) return;
+    }
+    if (IS_SYSTEM_DEFINED_TYPE(VALUE_TYPE(collection)) || IS_INTERNAL_NULL(ignoreNullGetAttr(collection, SYMBOL_HAS_NEXT)) || IS_INTERNAL_NULL(ignoreNullGetAttr(collection, SYMBOL_NEXT))) {
+        raiseExceptionByName("TypeError", "Iterator has no _hasNext or _next method");
+        return;
+    }
+    iterator[0] = collection;
+}
+
+bool iteratorNext(Value* iterator) {
+    Value collection = iterator[0];
+    switch (VALUE_TYPE(collection)) {
+        case VAL_NONE:
+            return false;
+        case BUILTIN_LIST: {
+            runtimeList* list = VALUE_LIST_VALUE(collection);
+            uint32_t index = (uint32_t) VALUE_NUMBER_VALUE(iterator[1]);
+            if (index >= list->size) return false;
+            iterator[1] = NUMBER_VAL(index + 1);
+            STACK_PUSH(list->list[index]);
+            return true;
+        }
+        case BUILTIN_FLOAT_ARRAY:
+        case BUILTIN_INT_ARRAY: {
+            runtimeArray* array = VALUE_ARRAY_VALUE(collection);
+            uint32_t index = (uint32_t) VALUE_NUMBER_VALUE(iterator[1]);
+            if (index >= array->size) return false;
+            iterator[1] = NUMBER_VAL(index + 1);
+            STACK_PUSH(NUMBER_VAL(VALUE_ARRAY_IS_INT(collection) ? (double) array->ints[index] : array->floats[index]));
+            return true;
+        }
+        case BUILTIN_DICT:
+        case BUILTIN_SET: {
+            // Walk entries in place, yields keys
+            uint32_t cursor = (uint32_t) VALUE_NUMBER_VALUE(iterator[1]);
+            Value key;
+            bool hasNext = VALUE_TYPE(collection) == BUILTIN_DICT ? dictIterateNext(VALUE_DICT_VALUE(collection), &cursor, &key)
+                                                                  : setIterateNext(VALUE_SET_VALUE(collection), &cursor, &key);
+            iterator[1] = NUMBER_VAL(cursor);
+            if (hasNext) STACK_PUSH(key);
+            return hasNext;
+        }
+        default: {
+            Value hasNext = execInput(ignoreNullGetAttr(collection, SYMBOL_HAS_NEXT), collection, NULL, 0);
+            if (vm->panic) return false;
+            if (VALUE_TYPE(hasNext) != VAL_BOOL) {
+                raiseExceptionByName("TypeError", "Result of _hasNext is not a boolean");
+                return false;
+            }
+            if (!VALUE_BOOL_VALUE(hasNext)) return false;
+            Value element = execInput(ignoreNullGetAttr(collection, SYMBOL_NEXT), collection, NULL, 0);
+            if (vm->panic) return false;
+            STACK_PUSH(element);
+            return true;
+        }
+    }
+}
+
 void freeVM() {
     if (vm == NULL) return;
     free(vm->globalRefArray);
@@ -971,7 +1309,7 @@ void defaultPrint(Value obj) {
 
 void printGlobalRefArray() {
     printf("[");
-    for (uint16_t i = 0; i < vm->globalRefCount; i++) {
+    for (uint32_t i = 0; i < vm->globalRefCount; i++) {
         // Find if print func is defined for the object
         Value obj = vm->globalRefArray[i];
         defaultPrint(obj);
@@ -14,7 +14,7 @@ typedef struct exceptionHandler {
     uint64_t** ipLoc;
     Value* stackLoc;
     uint16_t type;
-    uint16_t toLine;
+    uint32_t toLine;
     uint8_t batchCount;
     bool handlesAll;
 } exceptionHandler;
@@ -26,11 +26,11 @@ typedef struct {
     exceptionHandler* handlerStackTop;
     Value* globalRefArray; // Global reference array
     callable** functionArray; // Function array
-    uint16_t globalRefCount; // Number of global references
+    uint32_t globalRefCount; // Number of global references
     uint16_t localScopeCount; // Number of local scopes
     // Exception handling
     uint64_t** targetIP;
-    uint16_t targetLine;
+    uint32_t targetLine;
     Value* targetStackTop;
     bool panic;
 } VM;
@@ -43,17 +43,21 @@ void execChunk(Chunk* chunk, Value* dataSection);
 
 bool compareValue(Value v1, Value v2);
 
-void initVM(Value* globalRefArray, callable** functionArray, uint16_t globalRefCount);
+void initVM(Value* globalRefArray, callable** functionArray, uint32_t globalRefCount);
 
-Value unaryOperation(Value obj1, char* op);
+Value unaryOperation(Value obj1, uint32_t op);
 Value binaryOperation(Value v1, Value v2, OpCode op);
 
 Value performValueModification(specialAssignment sa, Value value, Value modValue);
 
 void indexSpecialAssignment(specialAssignment sa , Value target, Value index, Value value);
-void attrSpecialAssignment(specialAssignment sa, Value target, char* attrName, Value value);
+void attrSpecialAssignment(specialAssignment sa, Value target, uint32_t attrSymbol, Value value);
 
 Value objGetIndexRef(Value target, Value index);
+void objSetIndexRef(Value target, Value index, Value value);
+
+void initIterator(Value* iterator, Value collection);
+bool iteratorNext(Value* iterator);
 
 void freeVM();
 